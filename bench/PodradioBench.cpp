@@ -0,0 +1,247 @@
+#include "core/PodcastFeed.hpp"
+#include "core/FeedManager.hpp"
+#include "core/SearchIndex.hpp"
+#include "core/ThreadPool.hpp"
+#include "core/UrlClassifier.hpp"
+#ifdef ENABLE_BLUETOOTH
+#include "core/BluetoothServer.hpp"
+#include "core/PlayerRegistry.hpp"
+#endif
+#include <benchmark/benchmark.h>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace podradio::core;
+
+namespace {
+
+std::string readFixture(const std::string& name) {
+    std::ifstream file(std::string(PODRADIO_BENCH_FIXTURES) + "/" + name, std::ios::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error("Missing benchmark fixture: " + name);
+    }
+    std::stringstream content;
+    content << file.rdbuf();
+    return content.str();
+}
+
+// The recorded feed with its items repeated until there are itemCount of
+// them; guids stay unique so the result looks like a long back catalog
+std::string scaledFeed(size_t itemCount) {
+    static const std::string recorded = readFixture("feed_small.xml");
+    size_t first = recorded.find("<item>");
+    size_t last = recorded.rfind("</item>") + std::string("</item>").size();
+    std::string head = recorded.substr(0, first);
+    std::string items = recorded.substr(first, last - first);
+    std::string tail = recorded.substr(last);
+
+    size_t perCopy = 0;
+    for (size_t pos = items.find("<item>"); pos != std::string::npos; pos = items.find("<item>", pos + 1)) {
+        ++perCopy;
+    }
+
+    std::string xml = head;
+    for (size_t copy = 0; copy * perCopy < itemCount; ++copy) {
+        std::string block = items;
+        std::string suffix = "-" + std::to_string(copy) + "</guid>";
+        for (size_t pos = block.find("</guid>"); pos != std::string::npos;
+             pos = block.find("</guid>", pos + suffix.size())) {
+            block.replace(pos, 7, suffix);
+        }
+        xml += block;
+    }
+    return xml + tail;
+}
+
+const std::string& feedOfSize(int64_t itemCount) {
+    static const std::string small = readFixture("feed_small.xml");
+    static const std::string medium = scaledFeed(400);
+    static const std::string huge = scaledFeed(20000);
+    return itemCount <= 8 ? small : itemCount <= 400 ? medium : huge;
+}
+
+void BM_ParseFeed(benchmark::State& state) {
+    const std::string& xml = feedOfSize(state.range(0));
+    for (auto _ : state) {
+        PodcastFeed feed;
+        feed.loadFromString(xml);
+        benchmark::DoNotOptimize(feed.getEpisodes().size());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * xml.size()));
+}
+BENCHMARK(BM_ParseFeed)->Arg(8)->Arg(400)->Arg(20000)->Unit(benchmark::kMicrosecond);
+
+void BM_ParseFeedParallel(benchmark::State& state) {
+    const std::string& xml = feedOfSize(20000);
+    ThreadPool pool(static_cast<size_t>(state.range(0)));
+    FeedLoadOptions options;
+    options.parsePool = &pool;
+    for (auto _ : state) {
+        PodcastFeed feed;
+        feed.loadFromString(xml, options);
+        benchmark::DoNotOptimize(feed.getEpisodes().size());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * xml.size()));
+}
+BENCHMARK(BM_ParseFeedParallel)->Arg(2)->Arg(4)->Unit(benchmark::kMicrosecond);
+
+void BM_CleanUrl(benchmark::State& state) {
+    // Canonical CDN URLs take the fast path; the rest go through the full parser
+    const std::vector<std::string> urls = {
+        "https://cdn.example.com/science-hour/209.mp3",
+        "https://dts.podtrac.com/redirect.mp3/cdn.example.com/science-hour/210.mp3?utm_source=feed&aid=rss",
+        " https://CDN.example.com/science-hour/205.mp3 ",
+        "https://chrt.fm/track/EX4MPL/traffic.megaphone.fm/EXM1234567890.mp3?updated=1724662800",
+        "http://example.com/a%20b/episode.mp3#t=10",
+    };
+    for (auto _ : state) {
+        for (const auto& url : urls) {
+            benchmark::DoNotOptimize(UrlClassifier::clean(url));
+        }
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * urls.size()));
+}
+BENCHMARK(BM_CleanUrl);
+
+std::vector<Subscription> makeSubscriptions(size_t count) {
+    std::vector<Subscription> subscriptions;
+    subscriptions.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        std::string n = std::to_string(i);
+        subscriptions.emplace_back("Podcast " + n, "https://feeds.example.com/show-" + n + ".rss",
+                                   "Weekly episodes of show number " + n);
+    }
+    return subscriptions;
+}
+
+// Fresh storage file populated with count subscriptions, JSON or binary
+std::string prepareStore(size_t count, bool binary) {
+    auto dir = std::filesystem::temp_directory_path() / "podradio_bench";
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+    std::string path = (dir / (binary ? "podcasts.bin" : "podcasts.json")).string();
+    FeedManager manager(path);
+    manager.addPodcasts(makeSubscriptions(count));
+    manager.save();
+    return path;
+}
+
+void BM_FeedManagerSave(benchmark::State& state) {
+    std::string path = prepareStore(static_cast<size_t>(state.range(0)), state.range(1) != 0);
+    FeedManager manager(path);
+    bool added = false;
+    for (auto _ : state) {
+        // Each round changes the list so save() has something to write
+        state.PauseTiming();
+        added = added ? !manager.removePodcast("Bench Extra")
+                      : manager.addPodcast("Bench Extra", "https://feeds.example.com/extra.rss");
+        state.ResumeTiming();
+        manager.save();
+    }
+}
+BENCHMARK(BM_FeedManagerSave)
+    ->ArgNames({"subs", "binary"})
+    ->ArgsProduct({{10, 1000, 10000}, {0, 1}})
+    ->Unit(benchmark::kMicrosecond);
+
+void BM_FeedManagerLoad(benchmark::State& state) {
+    std::string path = prepareStore(static_cast<size_t>(state.range(0)), state.range(1) != 0);
+    FeedManager manager(path);
+    for (auto _ : state) {
+        manager.load();
+        benchmark::DoNotOptimize(manager.getSubscriptionCount());
+    }
+}
+BENCHMARK(BM_FeedManagerLoad)
+    ->ArgNames({"subs", "binary"})
+    ->ArgsProduct({{10, 1000, 10000}, {0, 1}})
+    ->Unit(benchmark::kMicrosecond);
+
+std::shared_ptr<const FeedCacheEntry> parsedEntry() {
+    PodcastFeed feed;
+    feed.loadFromString(feedOfSize(400));
+    FeedCacheEntry entry;
+    entry.episodes = feed.getEpisodes();
+    return std::make_shared<const FeedCacheEntry>(std::move(entry));
+}
+
+struct SearchFixture {
+    SubscriptionSnapshot::Ptr snapshot;
+    SearchIndex index;
+};
+
+// Index over subscriptionCount feeds of 400 episodes each, built once per size
+SearchFixture& searchFixture(size_t subscriptionCount) {
+    static std::map<size_t, std::unique_ptr<SearchFixture>> fixtures;
+    auto& fixture = fixtures[subscriptionCount];
+    if (!fixture) {
+        fixture = std::make_unique<SearchFixture>();
+        std::vector<SubscriptionSnapshot::Item> items;
+        for (const auto& subscription : makeSubscriptions(subscriptionCount)) {
+            items.push_back(std::make_shared<const Subscription>(subscription));
+        }
+        fixture->snapshot = std::make_shared<const SubscriptionSnapshot>(std::move(items));
+        fixture->index.syncSubscriptions(*fixture->snapshot);
+        auto entry = parsedEntry();
+        for (const auto& item : *fixture->snapshot) {
+            fixture->index.setEpisodes(item->id, entry);
+        }
+    }
+    return *fixture;
+}
+
+void BM_Search(benchmark::State& state) {
+    SearchIndex& index = searchFixture(static_cast<size_t>(state.range(0))).index;
+    SearchQuery query;
+    query.text = "chemistry of cof";
+    query.limit = 10;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(index.search(query).total);
+    }
+}
+BENCHMARK(BM_Search)->Arg(10)->Arg(100)->Unit(benchmark::kMicrosecond);
+
+// A 304 refresh hands the index an identical entry; nothing is re-tokenized
+void BM_SearchIndexRefresh(benchmark::State& state) {
+    SearchFixture& fixture = searchFixture(10);
+    auto refreshed = parsedEntry();
+    const std::string& id = (*fixture.snapshot)[0].id;
+    for (auto _ : state) {
+        fixture.index.setEpisodes(id, refreshed);
+    }
+}
+BENCHMARK(BM_SearchIndexRefresh)->Unit(benchmark::kMicrosecond);
+
+#ifdef ENABLE_BLUETOOTH
+// Parsed requests straight into the dispatcher: no socket, and the player
+// never opens media, so libvlc isn't even initialized
+void BM_DispatchCommand(benchmark::State& state) {
+    std::string path = prepareStore(1000, false);
+    FeedManager manager(path);
+    PlayerRegistry players;
+    BluetoothServer server(manager, players);
+
+    const std::vector<nlohmann::json> requests = {
+        {{"action", "get_status"}},
+        {{"action", "list_podcasts"}, {"offset", 100}, {"limit", 20}},
+        {{"action", "list_podcasts"}, {"limit", 50}, {"fields", {"name", "url"}}},
+        {{"action", "get_metrics"}},
+        {{"action", "no_such_action"}},
+    };
+    for (auto _ : state) {
+        for (const auto& request : requests) {
+            benchmark::DoNotOptimize(server.handleCommand(request));
+        }
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * requests.size()));
+}
+BENCHMARK(BM_DispatchCommand)->Unit(benchmark::kMicrosecond);
+#endif
+
+} // namespace
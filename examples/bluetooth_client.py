@@ -19,6 +19,9 @@ class PodRadioClient:
     def __init__(self):
         self.socket = None
         self.connected = False
+        self.buffer = ""
+        self.next_id = 1
+        self.status = {}  # Merged from pushed status events
     
     def connect(self, device_address=None):
         """Connect to PodRadio Bluetooth service"""
@@ -60,17 +63,53 @@ class PodRadioClient:
             return None
         
         try:
+            request_id = self.next_id
+            self.next_id += 1
+            command = dict(command, id=request_id)
             message = json.dumps(command) + "\n"
             self.socket.send(message.encode())
             
-            # Read response
-            response = self.socket.recv(4096).decode().strip()
-            return json.loads(response)
+            # Slow commands (play, add) are acknowledged first and completed
+            # later; wait for the completion so callers see the final result
+            while True:
+                message = self.read_message()
+                if message.get("event") == "command_completed" and message.get("id") == request_id:
+                    return message["result"]
+                if "event" in message:
+                    self.handle_event(message)
+                    continue
+                if message.get("id") not in (None, request_id):
+                    continue  # Stray reply to an earlier request
+                if message.get("success") and message.get("data", {}).get("status") == "accepted":
+                    continue
+                return message
             
         except Exception as e:
             print(f"❌ Command error: {e}")
             return None
     
+    def read_message(self):
+        """Read one newline-delimited JSON message"""
+        while "\n" not in self.buffer:
+            chunk = self.socket.recv(4096).decode()
+            if not chunk:
+                raise ConnectionError("Connection closed")
+            self.buffer += chunk
+        line, self.buffer = self.buffer.split("\n", 1)
+        return json.loads(line)
+    
+    def handle_event(self, event):
+        """Print a server-pushed event such as playback_started"""
+        data = event.get("data", {})
+        if event["event"] == "status":
+            self.status.update(data)  # Pushes only carry the fields that changed
+        elif event["event"] == "playback_started":
+            print(f"🎵 Playback started: {data.get('episode', data.get('url', ''))}")
+        elif event["event"] == "playback_failed":
+            print(f"❌ Playback failed: {data.get('error', 'Unknown error')}")
+        else:
+            print(f"📣 Event: {event['event']}")
+    
     def disconnect(self):
         """Disconnect from PodRadio"""
         if self.socket:
@@ -85,6 +124,47 @@ class PodRadioClient:
             return response["data"]
         return None
     
+    def get_metrics(self):
+        """Get latency histograms and counters"""
+        response = self.send_command({"action": "get_metrics"})
+        if response and response.get("success"):
+            return response["data"]
+        return None
+    
+    def subscribe(self, interval_ms=1000):
+        """Ask the server to push status changes instead of polling get_status"""
+        response = self.send_command({"action": "subscribe", "interval_ms": interval_ms})
+        if response and response.get("success"):
+            self.status = dict(response["data"]["status"])
+            return True
+        return False
+    
+    def unsubscribe(self):
+        """Stop status pushes"""
+        return self.send_command({"action": "unsubscribe"})
+    
+    def watch_status(self, seconds=10):
+        """Print pushed status updates for a while"""
+        deadline = time.time() + seconds
+        self.socket.settimeout(0.5)
+        try:
+            while time.time() < deadline:
+                try:
+                    message = self.read_message()
+                except bluetooth.BluetoothError as e:
+                    if "timed out" in str(e):
+                        continue
+                    raise
+                if "event" in message:
+                    self.handle_event(message)
+                    if message["event"] == "status":
+                        s = self.status
+                        print(f"📡 {s.get('state')} {s.get('position_ms', 0) // 1000}s"
+                              f"/{s.get('length_ms', 0) // 1000}s buffer {s.get('buffering', 0)}%"
+                              f" - {s.get('podcast') or 'no podcast'}")
+        finally:
+            self.socket.settimeout(None)
+    
     def list_podcasts(self):
         """List all podcasts"""
         response = self.send_command({"action": "list_podcasts"})
@@ -92,6 +172,19 @@ class PodRadioClient:
             return response["data"]["podcasts"]
         return []
     
+    def search(self, query, scope="all", limit=10, offset=0):
+        """Search podcasts and cached episodes; returns one page of results"""
+        response = self.send_command({
+            "action": "search",
+            "query": query,
+            "scope": scope,
+            "limit": limit,
+            "offset": offset
+        })
+        if response and response.get("success"):
+            return response["data"]
+        return None
+    
     def add_podcast(self, name, url, description=""):
         """Add a new podcast"""
         command = {
@@ -110,26 +203,28 @@ class PodRadioClient:
         }
         return self.send_command(command)
     
-    def play_podcast(self, url=None):
-        """Play current podcast or from URL"""
+    def play_podcast(self, url=None, zone=None):
+        """Play current podcast or from URL, in the default zone unless one is given"""
         command = {"action": "play_podcast"}
         if url:
             command["url"] = url
+        if zone:
+            command["zone"] = zone
         return self.send_command(command)
     
-    def pause_playback(self):
+    def pause_playback(self, zone=None):
         """Pause playback"""
-        return self.send_command({
-            "action": "player_control",
-            "command": "pause"
-        })
+        command = {"action": "player_control", "command": "pause"}
+        if zone:
+            command["zone"] = zone
+        return self.send_command(command)
     
-    def stop_playback(self):
+    def stop_playback(self, zone=None):
         """Stop playback"""
-        return self.send_command({
-            "action": "player_control",
-            "command": "stop"
-        })
+        command = {"action": "player_control", "command": "stop"}
+        if zone:
+            command["zone"] = zone
+        return self.send_command(command)
     
     def navigate_podcasts(self, direction):
         """Navigate to next or previous podcast"""
@@ -202,9 +297,10 @@ def interactive_menu(client):
         print("8. Stop Playback")
         print("9. Next Podcast")
         print("10. Previous Podcast")
+        print("11. Watch Status (10s)")
         print("0. Quit")
         
-        choice = input("\nEnter your choice (0-10): ").strip()
+        choice = input("\nEnter your choice (0-11): ").strip()
         
         if choice == "0":
             break
@@ -252,7 +348,7 @@ def interactive_menu(client):
             response = client.play_podcast()
             if response and response.get("success"):
                 data = response["data"]
-                print(f"✅ Playing: {data.get('episode', 'Current podcast')}")
+                print(f"⏳ Starting: {data.get('episode', 'Current podcast')}")
             else:
                 print(f"❌ Playback failed: {response.get('error', 'Unknown error')}")
         
@@ -261,7 +357,7 @@ def interactive_menu(client):
             if url:
                 response = client.play_podcast(url)
                 if response and response.get("success"):
-                    print(f"✅ Playing from URL: {url}")
+                    print(f"⏳ Starting playback from URL: {url}")
                 else:
                     print(f"❌ Playback failed: {response.get('error', 'Unknown error')}")
             else:
@@ -297,6 +393,13 @@ def interactive_menu(client):
             else:
                 print(f"❌ Navigation failed: {response.get('error', 'Unknown error')}")
         
+        elif choice == "11":
+            if client.subscribe():
+                client.watch_status(10)
+                client.unsubscribe()
+            else:
+                print("❌ Subscribe failed")
+        
         else:
             print("❌ Invalid choice")
         
@@ -1,14 +1,19 @@
 #pragma once
 
 #include "core/FeedManager.hpp"
-#include "core/Player.hpp"
+#include "core/PlayerRegistry.hpp"
+#include "core/ThreadPool.hpp"
+#include "core/FrameParser.hpp"
 #include <thread>
 #include <mutex>
+#include <chrono>
 #include <atomic>
 #include <string>
 #include <vector>
+#include <deque>
 #include <memory>
 #include <functional>
+#include <unordered_map>
 #include <nlohmann/json.hpp>
 
 extern "C" {
@@ -21,19 +26,48 @@ extern "C" {
 namespace podradio {
 namespace core {
 
+// Wire format of a connection. JSON is newline-delimited; the binary
+// encodings carry one 4-byte big-endian length-prefixed message per frame.
+enum class WireEncoding { Json, Cbor, MessagePack };
+
+// How sendResponse treats a client whose outbound queue is backing up.
+// Droppable messages (e.g. status pushes) are skipped once the queue holds a
+// little data; any message that would overflow the hard limit disconnects.
+enum class Delivery { Required, Droppable };
+
 struct BluetoothClient {
     int socket;
     std::string address;
-    std::thread clientThread;
     std::atomic<bool> connected{true};
+
+    // Inbound frames; only touched by the event loop thread
+    FrameParser frames;
+
+    // Encoded frames not yet accepted by the socket. Any thread may queue;
+    // once a send would block, the event loop drains the queue on EPOLLOUT.
+    std::mutex writeMutex;
+    std::deque<std::string> writeQueue;
+    size_t writeOffset = 0;  // Bytes of the front frame already sent
+    size_t queuedBytes = 0;
+    bool wantsWrite = false;
+    WireEncoding encoding = WireEncoding::Json; // Guarded by writeMutex
+
+    // Status subscription; only touched by the event loop thread
+    bool subscribed = false;
+    std::string zone; // Zone whose status is pushed
+    std::chrono::milliseconds pushInterval{1000};
+    std::chrono::steady_clock::time_point lastPush;
+    nlohmann::json lastStatus; // Last state pushed, so only changes are sent
     
-    BluetoothClient(int sock, const std::string& addr) 
-        : socket(sock), address(addr) {}
+    BluetoothClient(int sock, const std::string& addr, size_t maxMessageBytes)
+        : socket(sock), address(addr), frames(maxMessageBytes) {}
 };
 
 class BluetoothServer {
 public:
-    BluetoothServer(FeedManager& feedManager, Player& player, int port = 1);
+    // Serves the zones players holds at construction. Requests pick one with
+    // a "zone" field; without it they address the registry's default zone.
+    BluetoothServer(FeedManager& feedManager, PlayerRegistry& players, int port = 1);
     ~BluetoothServer();
     
     // Server control
@@ -46,7 +80,7 @@ public:
     void setServiceDescription(const std::string& desc) { serviceDescription_ = desc; }
     
     // Client management
-    int getConnectedClientCount() const { return connectedClients_.size(); }
+    int getConnectedClientCount() const;
     std::vector<std::string> getConnectedClients() const;
     
     // Callbacks for events
@@ -60,10 +94,25 @@ public:
         onCommandReceived_ = callback;
     }
 
+    // Dispatch one decoded request outside any connection and return the
+    // response. Per-connection actions (subscribe, set_encoding) aren't
+    // available here. Used by the benchmarks.
+    nlohmann::json handleCommand(const nlohmann::json& request);
+
 private:
+    // Playback state kept per zone
+    struct Zone {
+        std::string name;
+        Player& player;
+        std::atomic<uint64_t> playGeneration{0}; // Bumped to cancel pending plays
+        nlohmann::json nowPlaying; // Episode behind the current playback, null if unknown; guarded by nowPlayingMutex_
+
+        Zone(const std::string& zoneName, Player& zonePlayer) : name(zoneName), player(zonePlayer) {}
+    };
+
     // Core references
     FeedManager& feedManager_;
-    Player& player_;
+    std::vector<std::unique_ptr<Zone>> zones_; // Default zone first
     
     // Bluetooth configuration
     int port_;
@@ -75,13 +124,23 @@ private:
     int serverSocket_;
     sdp_session_t* sdpSession_;
     
-    // Client management
-    std::vector<std::shared_ptr<BluetoothClient>> connectedClients_;
+    // Client management, keyed by socket
+    std::unordered_map<int, std::shared_ptr<BluetoothClient>> connectedClients_;
     mutable std::mutex clientsMutex_;
     
-    // Threading
+    // Event loop: one thread multiplexes the listening socket and all clients
     std::thread serverThread_;
-    std::thread cleanupThread_;
+    int epollFd_;
+    int wakeupFd_; // eventfd used to interrupt epoll_wait (stop, status changes)
+
+    // Status push: producers set statusDirty_ and wake the loop, which sends
+    // coalesced diffs to subscribers no faster than their push interval
+    std::atomic<bool> statusDirty_{false};
+    bool pushPending_ = false; // A subscriber is waiting out its interval; loop thread only
+    std::mutex nowPlayingMutex_;
+
+    // Slow commands (play, add) run here so the event loop keeps answering
+    std::unique_ptr<ThreadPool> commandPool_;
     
     // Event callbacks
     std::function<void(const std::string&)> onClientConnected_;
@@ -90,28 +149,54 @@ private:
     
     // Private methods
     void serverLoop();
-    void handleClient(std::shared_ptr<BluetoothClient> client);
-    void cleanupDisconnectedClients();
+    void acceptClients();
+    bool readFromClient(const std::shared_ptr<BluetoothClient>& client);
+    void processMessage(const std::shared_ptr<BluetoothClient>& client, std::string_view message);
+    void runSlowCommand(const std::shared_ptr<BluetoothClient>& client, nlohmann::json request,
+                        std::chrono::steady_clock::time_point received);
+    void closeClient(const std::shared_ptr<BluetoothClient>& client);
+    void closeAllClients();
+    void notifyStatusChanged();
+    // Returns the epoll_wait timeout until the next rate-limited push, or -1
+    int pushStatusUpdates();
+    nlohmann::json buildStatus(Zone& zone);
+    // Zone named by the request's "zone" field (the default zone if absent);
+    // nullptr with error set for unknown or malformed names
+    Zone* findZone(const nlohmann::json& request, std::string& error);
+    Zone* findZone(const std::string& name);
     
     // SDP (Service Discovery Protocol) methods
     bool registerService();
     void unregisterService();
     
     // Protocol handlers
-    nlohmann::json handleCommand(const std::string& command, const std::string& clientAddress);
+    static bool isSlowCommand(const std::string& action);
     nlohmann::json handleAddPodcast(const nlohmann::json& request);
+    nlohmann::json handleAddPodcasts(const nlohmann::json& request);
     nlohmann::json handleRemovePodcast(const nlohmann::json& request);
     nlohmann::json handleListPodcasts(const nlohmann::json& request);
-    nlohmann::json handlePlayPodcast(const nlohmann::json& request);
+    // Gives up with "Cancelled" once the zone's playGeneration moves past generation
+    nlohmann::json handlePlayPodcast(const nlohmann::json& request, Zone& zone, uint64_t generation);
     nlohmann::json handlePlayerControl(const nlohmann::json& request);
     nlohmann::json handleGetStatus(const nlohmann::json& request);
+    nlohmann::json handleGetMetrics(const nlohmann::json& request);
+    nlohmann::json handleSearch(const nlohmann::json& request);
     nlohmann::json handleNavigatePodcasts(const nlohmann::json& request);
+    nlohmann::json handleSubscribe(BluetoothClient& client, const nlohmann::json& request);
+    nlohmann::json handleUnsubscribe(BluetoothClient& client);
+    // Replies in the old encoding, then switches the connection over
+    void handleSetEncoding(const std::shared_ptr<BluetoothClient>& client, const nlohmann::json& request);
     
     // Utility methods
-    void sendResponse(int clientSocket, const nlohmann::json& response);
+    // Returns false if the message was dropped or the client is gone
+    bool sendResponse(const std::shared_ptr<BluetoothClient>& client, const nlohmann::json& response,
+                      Delivery delivery = Delivery::Required);
+    void flushClient(BluetoothClient& client); // Caller holds client.writeMutex
+    void updateInterest(BluetoothClient& client, bool wantsWrite);
     void broadcastMessage(const nlohmann::json& message);
     nlohmann::json createErrorResponse(const std::string& error, const std::string& details = "");
     nlohmann::json createSuccessResponse(const nlohmann::json& data = nlohmann::json::object());
+    void preloadAdjacentEpisodes(Player& player);
     
     // Bluetooth utility methods
     std::string getBluetoothAddress(int socket);
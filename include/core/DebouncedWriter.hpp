@@ -0,0 +1,67 @@
+#pragma once
+
+#include <string>
+#include <functional>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+namespace podradio {
+namespace core {
+
+// Write the file through a temporary sibling, fsync it, rename it into place
+// and fsync the directory, so a crash or power cut leaves either the old or
+// the new content, never a torn file.
+bool writeFileAtomically(const std::string& path, const std::string& content);
+
+// Write-behind persistence for one file. markDirty() is cheap and never does
+// I/O; a background thread calls serialize() and writes the result once no
+// further change has arrived for `delay`, or at the latest `maxDelay` after
+// the first unsaved change. Bursts of changes therefore cost one write.
+class DebouncedWriter {
+public:
+    using Serializer = std::function<std::string()>;
+
+    DebouncedWriter(std::string path, Serializer serialize,
+                    std::chrono::milliseconds delay = std::chrono::milliseconds(500),
+                    std::chrono::milliseconds maxDelay = std::chrono::seconds(5));
+    // Writes any pending change before returning
+    ~DebouncedWriter();
+
+    DebouncedWriter(const DebouncedWriter&) = delete;
+    DebouncedWriter& operator=(const DebouncedWriter&) = delete;
+
+    void markDirty();
+
+    // Write a pending change now, on the calling thread. If the write fails
+    // the change stays pending and the writer thread retries it.
+    void flush();
+
+    bool isDirty() const;
+    const std::string& getPath() const { return path_; }
+
+private:
+    void writerLoop();
+    bool write();
+    // After a failed write: mark the change pending again and re-arm the timer
+    void retryLocked();
+
+    std::string path_;
+    Serializer serialize_;
+    std::chrono::milliseconds delay_;
+    std::chrono::milliseconds maxDelay_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    bool dirty_;
+    bool stopping_;
+    std::chrono::steady_clock::time_point firstChange_;
+    std::chrono::steady_clock::time_point lastChange_;
+
+    std::mutex writeMutex_; // Serializes flush() against the writer thread
+    std::thread thread_;
+};
+
+} // namespace core
+} // namespace podradio
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "core/EpisodeStore.hpp"
+#include "core/DebouncedWriter.hpp"
+#include "core/ThreadPool.hpp"
+#include <string>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <cstdint>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace podradio {
+namespace core {
+
+struct DownloadOptions {
+    std::string directory = "downloads";
+    size_t episodesPerSubscription = 2;        // Newest episodes kept offline per feed
+    size_t maxConcurrent = 2;                  // Parallel transfers
+    int64_t bandwidthBytesPerSecond = 0;       // Shared by all transfers; 0 = unlimited
+    uint64_t diskQuotaBytes = 2ULL << 30;      // Completed downloads beyond this are evicted LRU
+};
+
+// Keeps recent episodes on local storage so playback doesn't depend on the
+// network. Transfers run on a small pool, resume interrupted files with HTTP
+// Range requests and share a bandwidth budget. Completed files are tracked
+// in an index next to them; once they exceed the disk quota the least
+// recently played ones are deleted. All methods are thread-safe.
+class DownloadManager {
+public:
+    explicit DownloadManager(const DownloadOptions& options = DownloadOptions());
+    // Aborts running transfers; their partial files are resumed next time
+    ~DownloadManager();
+
+    DownloadManager(const DownloadManager&) = delete;
+    DownloadManager& operator=(const DownloadManager&) = delete;
+
+    // Queue a download unless the episode is already stored or queued
+    void enqueue(const std::string& url);
+    // Queue the newest episodesPerSubscription episodes of a feed
+    void enqueueLatest(const EpisodeStore& episodes);
+
+    // Path of the completed local copy of url, or empty. Counts as a use for LRU.
+    std::string localPathFor(const std::string& url);
+
+    uint64_t getStoredBytes() const;
+    size_t getPendingCount() const;
+    const DownloadOptions& getOptions() const { return options_; }
+
+private:
+    struct Entry {
+        std::string file;       // Name inside the download directory
+        uint64_t size = 0;      // Bytes of the completed file
+        bool complete = false;
+        int64_t lastUsed = 0;   // Milliseconds since epoch
+    };
+
+    void download(const std::string& url);
+    bool transfer(const std::string& url, const std::string& partPath);
+    void evictLocked(const std::string& keepUrl);
+    void loadIndex();
+    std::string serializeIndex() const;
+    std::string pathOf(const std::string& file) const;
+    static std::string fileNameFor(const std::string& url);
+
+    DownloadOptions options_;
+
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, Entry> entries_; // Keyed by episode URL
+    std::unordered_set<std::string> queued_;         // Queued or downloading
+    uint64_t storedBytes_;
+
+    std::atomic<bool> stopping_{false};
+    DebouncedWriter indexWriter_;
+    std::unique_ptr<ThreadPool> pool_; // Declared last so workers stop first
+};
+
+} // namespace core
+} // namespace podradio
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+
+namespace podradio {
+namespace core {
+
+struct Episode {
+    std::string title;
+    std::string description;
+    std::string url;
+    std::string pubDate;
+    std::string duration;
+    std::string guid;
+};
+
+// Non-owning view of an episode held by an EpisodeStore. Views stay valid
+// until the store is modified or destroyed.
+struct EpisodeView {
+    std::string_view title;
+    std::string_view rawDescription; // XML-escaped when descriptionEncoded is set
+    std::string_view url;
+    std::string_view pubDate;
+    std::string_view duration;
+    std::string_view guid;
+    bool descriptionEncoded = false;
+
+    // Decodes the description on demand
+    std::string description() const;
+
+    // Owning copy for callers that outlive the store
+    Episode toEpisode() const;
+};
+
+// Episode list backed by a single contiguous string arena per feed, so a
+// feed costs three allocations (arena, records, guid table) instead of six
+// strings and an index node per episode.
+class EpisodeStore {
+public:
+    void clear();
+    void reserve(size_t episodeCount, size_t arenaBytes);
+
+    void add(std::string_view title, std::string_view description, std::string_view url,
+             std::string_view pubDate, std::string_view duration, std::string_view guid,
+             bool descriptionEncoded = false);
+    void add(const Episode& episode);
+    void add(const EpisodeView& episode); // View must come from another store
+
+    size_t size() const { return records_.size(); }
+    bool empty() const { return records_.empty(); }
+    size_t arenaBytes() const { return arena_.size(); }
+
+    EpisodeView operator[](size_t index) const;
+    EpisodeView front() const { return (*this)[0]; }
+
+    // Index of the first episode with the given guid, or -1 (hash lookup)
+    int findGuid(std::string_view guid) const;
+
+private:
+    struct Span {
+        uint32_t offset;
+        uint32_t length;
+    };
+
+    enum Field { Title, Description, Url, PubDate, Duration, Guid, FieldCount };
+
+    struct Record {
+        Span fields[FieldCount];
+        bool descriptionEncoded;
+    };
+
+    // Open-addressed guid table slot. Holds the hash and record index rather
+    // than a string_view so it survives arena growth.
+    struct GuidSlot {
+        uint32_t hash;
+        uint32_t record; // kEmptySlot when free
+    };
+    static constexpr uint32_t kEmptySlot = UINT32_MAX;
+
+    Span store(std::string_view value);
+    std::string_view view(const Span& span) const;
+    void indexGuid(std::string_view guid, uint32_t record);
+    void rehashGuids(size_t slotCount);
+
+    std::string arena_;
+    std::vector<Record> records_;
+    std::vector<GuidSlot> guidSlots_; // Power-of-two size, at most half full
+    size_t guidCount_ = 0;
+};
+
+} // namespace core
+} // namespace podradio
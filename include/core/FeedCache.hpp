@@ -0,0 +1,65 @@
+#pragma once
+
+#include "core/PodcastFeed.hpp"
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <mutex>
+#include <nlohmann/json.hpp>
+
+namespace podradio {
+namespace core {
+
+struct FeedCacheEntry {
+    std::string etag;
+    std::string lastModified;
+    std::chrono::system_clock::time_point fetchedAt; // When this body was downloaded
+    EpisodeStore episodes;
+    bool truncated = false; // Head-only fetch: newest episodes only, back catalog missing
+
+    // JSON serialization
+    nlohmann::json toJson() const;
+    static FeedCacheEntry fromJson(const nlohmann::json& j);
+};
+
+// Persistent feed cache keyed by Subscription::id. Each entry lives in its
+// own file inside the cache directory and is mirrored in memory once read.
+// Entries are shared immutably, so readers never copy episode lists.
+// All methods are safe to call from multiple threads; disk I/O happens
+// outside the lock that get() takes.
+class FeedCache {
+public:
+    explicit FeedCache(const std::string& cacheDirectory = "feed_cache");
+
+    // Returns nullptr when the subscription has no cached feed
+    std::shared_ptr<const FeedCacheEntry> get(const std::string& subscriptionId);
+    std::shared_ptr<const FeedCacheEntry> put(const std::string& subscriptionId, FeedCacheEntry entry);
+    void remove(const std::string& subscriptionId);
+
+    // Records that the feed was revalidated (e.g. a 304) at checkedAt without
+    // rewriting its body. Kept in memory only: after a restart the entry's
+    // fetchedAt applies again, which costs at most one extra conditional GET.
+    void touch(const std::string& subscriptionId, std::chrono::system_clock::time_point checkedAt);
+    // Latest of the entry's fetchedAt and any touch(); epoch when unknown
+    std::chrono::system_clock::time_point getCheckedAt(const std::string& subscriptionId) const;
+
+    const std::string& getDirectory() const { return cacheDirectory_; }
+
+private:
+    std::string entryPath(const std::string& subscriptionId) const;
+
+    std::string cacheDirectory_;
+    std::unordered_map<std::string, std::shared_ptr<const FeedCacheEntry>> entries_;
+    std::unordered_map<std::string, std::chrono::system_clock::time_point> checkedAt_;
+    // remove() calls per id, so a get() that overlapped one drops what it read
+    std::unordered_map<std::string, uint64_t> removals_;
+    mutable std::mutex mutex_;
+    // Serializes file writes and removals; taken before mutex_, never inside it
+    std::mutex writeMutex_;
+};
+
+} // namespace core
+} // namespace podradio
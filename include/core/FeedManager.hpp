@@ -2,49 +2,111 @@
 
 #include "core/Subscription.hpp"
 #include "core/PodcastFeed.hpp"
+#include "core/FeedCache.hpp"
+#include "core/DebouncedWriter.hpp"
+#include "core/SubscriptionSnapshot.hpp"
+#include "core/SearchIndex.hpp"
 #include <vector>
 #include <string>
 #include <memory>
 #include <optional>
+#include <mutex>
+#include <atomic>
+#include <chrono>
 
 namespace podradio {
 namespace core {
 
+// All public methods are safe to call from multiple threads. Readers work on
+// immutable snapshots and never block; writers serialize among themselves and
+// publish a new snapshot atomically.
 class FeedManager {
 public:
+    // A ".bin" storageFile selects the memory-mapped binary store (see
+    // SubscriptionStore); a JSON file with the same stem is imported once.
     FeedManager(const std::string& storageFile = "podcasts.json");
     ~FeedManager();
 
     // Subscription management
     bool addPodcast(const std::string& name, const std::string& feedUrl, const std::string& description = "");
+    // Bulk import (e.g. from OPML). Entries with an empty name or URL, or that
+    // clash with an existing or earlier entry, are skipped. Persists once and
+    // returns how many were added.
+    size_t addPodcasts(const std::vector<Subscription>& podcasts);
     bool removePodcast(const std::string& identifier); // Can be name or feed URL
+
+    // Current subscription list; cheap, lock-free and never copies entries
+    SubscriptionSnapshot::Ptr getSnapshot() const;
+    // Copies every subscription; prefer getSnapshot()
     std::vector<Subscription> getSubscriptions() const;
     
     // Navigation
-    std::optional<Subscription> getCurrentPodcast() const;
+    std::shared_ptr<const Subscription> getCurrentPodcast() const; // nullptr if none
     std::optional<Subscription> nextPodcast();
     std::optional<Subscription> previousPodcast();
     bool selectPodcast(const std::string& identifier); // Can be name or feed URL
     
-    // Playback helper
+    // Playback helper - revalidates the cached feed with a conditional GET.
+    // Without a complete cached feed it does a head-only fetch, so the cost
+    // doesn't grow with the size of the back catalog.
     std::optional<Episode> getLatestEpisode(const Subscription& subscription);
+
+    // Latest cached episodes of the subscriptions either side of the current
+    // one (next first), for preloading. Never touches the network.
+    std::vector<Episode> getAdjacentEpisodes();
+
+    // Fetch (or revalidate) a subscription's feed into the cache and bump its
+    // lastUpdated timestamp. Returns the cache entry, or nullptr on failure.
+    // headOnly stops the download after the newest few items; the entry is
+    // marked truncated and the next full refresh fetches the whole feed.
+    // parsePool, when given, post-processes large feeds' items in parallel.
+    std::shared_ptr<const FeedCacheEntry> refreshFeed(const Subscription& subscription, bool headOnly = false,
+                                                      ThreadPool* parsePool = nullptr);
+
+    // Search subscription names and cached episodes. Feeds are indexed as
+    // they're refreshed; cached feeds not refreshed yet are indexed on the
+    // first search. Episode hits carry the cache entry to read them from.
+    SearchResults search(const SearchQuery& query);
+    // Index the cached feeds search() would otherwise index on first use
+    void prepareSearch();
+
+    // Cache entries younger than this are served without touching the network.
+    // Zero (the default) revalidates on every getLatestEpisode call.
+    void setFreshnessWindow(std::chrono::seconds window) { freshnessWindow_ = window; }
     
-    // Persistence
+    // Persistence. Changes are written behind, coalesced over a short window;
+    // save() writes anything still pending immediately.
     void save();
     void load();
     
     // Status
-    int getCurrentIndex() const { return currentIndex_; }
-    int getSubscriptionCount() const { return subscriptions_.size(); }
+    int getCurrentIndex() const;
+    int getSubscriptionCount() const;
     
 private:
-    std::vector<Subscription> subscriptions_;
-    int currentIndex_;
+    SubscriptionSnapshot::Ptr snapshot_; // Only accessed via std::atomic_load/store
+    std::atomic<int> currentIndex_;
     std::string storageFile_;
+    FeedCache feedCache_;
+    SearchIndex searchIndex_; // Kept in step with every published snapshot
+    std::chrono::seconds freshnessWindow_{0};
+    mutable std::mutex mutex_; // Serializes writers; readers never take it
+
+    // Declared last so pending writes flush while the state is still alive.
+    // Navigation only touches the small index record.
+    DebouncedWriter subscriptionsWriter_;
+    DebouncedWriter indexWriter_;
     
-    // Helper methods
-    int findSubscriptionIndex(const std::string& identifier) const;
-    void ensureValidIndex();
+    // Helper methods (callers must hold mutex_)
+    void publish(SubscriptionSnapshot::Ptr snapshot);
+    void ensureValidIndex(const SubscriptionSnapshot& snapshot);
+    static bool loadJson(const std::string& path, std::vector<SubscriptionSnapshot::Item>& items, int& index);
+    static bool insertSubscription(std::vector<SubscriptionSnapshot::Item>& items, SubscriptionIndex& index,
+                                   const std::string& name, const std::string& feedUrl, const std::string& description);
+
+    // Run on the writer threads; read the published snapshot
+    std::string serializeSubscriptions() const;
+    std::string serializeIndex() const;
 };
 
 } // namespace core
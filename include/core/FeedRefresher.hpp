@@ -0,0 +1,70 @@
+#pragma once
+
+#include "core/FeedManager.hpp"
+#include "core/RefreshSchedule.hpp"
+#include "core/ThreadPool.hpp"
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+#include <functional>
+
+namespace podradio {
+namespace core {
+
+// Refreshes every enabled subscription ahead of time on a bounded worker
+// pool so that FeedManager::getLatestEpisode can answer from the cache.
+// With adaptive scheduling each feed is fetched when its RefreshSchedule
+// says it is due; otherwise all feeds are fetched every interval.
+class FeedRefresher {
+public:
+    FeedRefresher(FeedManager& feedManager, const RefreshOptions& options = RefreshOptions());
+    ~FeedRefresher();
+
+    // Periodic background scheduling
+    void start();
+    void stop();
+    bool isRunning() const { return running_; }
+
+    // Refresh all enabled subscriptions now; blocks until the round finishes.
+    // Returns the number of feeds that were fetched successfully.
+    size_t refreshAll();
+
+    const RefreshSchedule& getSchedule() const { return schedule_; }
+
+    // Invoked on a worker thread after each successful feed refresh
+    void setOnFeedRefreshed(std::function<void(const Subscription&, const FeedCacheEntry&)> callback) {
+        onFeedRefreshed_ = callback;
+    }
+
+private:
+    void schedulerLoop();
+    // Fetches the given subscriptions, recording each outcome in the schedule
+    size_t refreshSubscriptions(const std::vector<Subscription>& subscriptions);
+    std::chrono::milliseconds nextDelay();
+    std::chrono::milliseconds untilNextDue() const;
+    static std::string hostOf(const std::string& url);
+
+    FeedManager& feedManager_;
+    RefreshOptions options_;
+    RefreshSchedule schedule_;
+    std::unique_ptr<ThreadPool> pool_; // Created on the first refresh round
+
+    std::atomic<bool> running_{false};
+    std::thread schedulerThread_;
+    std::mutex scheduleMutex_;
+    std::condition_variable scheduleCv_;
+
+    // Serializes refresh rounds (scheduled and manual)
+    std::mutex roundMutex_;
+
+    // Event callbacks
+    std::function<void(const Subscription&, const FeedCacheEntry&)> onFeedRefreshed_;
+};
+
+} // namespace core
+} // namespace podradio
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace podradio {
+namespace core {
+
+// Splits a byte stream into message frames, either newline-delimited or
+// prefixed with a 4-byte big-endian length. Bytes are read straight into the
+// parser's buffer and frames are returned as views into it, so nothing is
+// copied per message; consumed space is reclaimed lazily in prepare().
+class FrameParser {
+public:
+    enum class Framing { Line, LengthPrefixed };
+
+    explicit FrameParser(size_t maxFrameBytes = 64 * 1024, Framing framing = Framing::Line);
+
+    // Writable space for at least `bytes` more bytes; report what was filled with commit()
+    char* prepare(size_t bytes);
+    void commit(size_t bytes);
+    void append(std::string_view data);
+
+    // Next complete frame, valid until the following prepare() or append().
+    // Returns false when more input is needed or the stream is broken.
+    bool next(std::string_view& frame);
+
+    // Applies to frames not yet returned by next()
+    void setFraming(Framing framing);
+    Framing getFraming() const { return framing_; }
+
+    bool hasError() const { return !error_.empty(); }
+    const std::string& getError() const { return error_; }
+    size_t buffered() const { return end_ - begin_; }
+
+    // Length prefix for an outgoing LengthPrefixed frame
+    static void appendLengthPrefix(std::string& out, uint32_t length);
+
+private:
+    std::vector<char> buffer_;
+    size_t begin_;   // First unconsumed byte
+    size_t end_;     // One past the last committed byte
+    size_t scanned_; // Bytes after begin_ already searched for a newline
+    size_t maxFrameBytes_;
+    Framing framing_;
+    std::string error_;
+};
+
+} // namespace core
+} // namespace podradio
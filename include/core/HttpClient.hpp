@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cpr/cpr.h>
+#include <curl/curl.h>
+#include <string>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <unordered_map>
+
+namespace podradio {
+namespace core {
+
+// Process-wide HTTP layer shared by feed fetches, redirect resolution and
+// downloads. Sessions are pooled per origin so their keep-alive connections
+// are reused, and every session joins one curl share handle holding the DNS
+// cache, TLS sessions and connection cache. HTTP/2 is negotiated over TLS.
+class HttpClient {
+public:
+    // A pooled session, handed back to the pool when the lease ends.
+    // Each lease starts from the client defaults; set headers, timeouts and
+    // limits for the request at hand.
+    class Lease {
+    public:
+        Lease(Lease&& other) noexcept;
+        Lease& operator=(Lease&&) = delete;
+        ~Lease();
+
+        cpr::Session& operator*() { return *session_; }
+        cpr::Session* operator->() { return session_.get(); }
+
+    private:
+        friend class HttpClient;
+        Lease(HttpClient& client, std::string origin, std::unique_ptr<cpr::Session> session);
+
+        HttpClient* client_;
+        std::string origin_;
+        std::unique_ptr<cpr::Session> session_;
+    };
+
+    static HttpClient& shared();
+
+    ~HttpClient();
+    HttpClient(const HttpClient&) = delete;
+    HttpClient& operator=(const HttpClient&) = delete;
+
+    // Session for url's origin (scheme, host and port); the URL itself is not set
+    Lease acquire(const std::string& url);
+
+    size_t getIdleSessionCount() const;
+
+private:
+    HttpClient();
+
+    void release(const std::string& origin, std::unique_ptr<cpr::Session> session);
+    std::unique_ptr<cpr::Session> createSession();
+    static void resetToDefaults(cpr::Session& session);
+    static std::string originOf(const std::string& url);
+
+    static void lockShared(CURL* handle, curl_lock_data data, curl_lock_access access, void* userptr);
+    static void unlockShared(CURL* handle, curl_lock_data data, void* userptr);
+
+    CURLSH* share_;
+    std::mutex shareMutexes_[CURL_LOCK_DATA_LAST];
+
+    mutable std::mutex poolMutex_;
+    std::unordered_map<std::string, std::vector<std::unique_ptr<cpr::Session>>> idle_;
+};
+
+} // namespace core
+} // namespace podradio
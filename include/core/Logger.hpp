@@ -0,0 +1,113 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+
+namespace podradio {
+namespace core {
+
+enum class LogLevel { Debug = 0, Info = 1, Warning = 2, Error = 3 };
+
+// Leveled logger with an asynchronous sink. log() formats nothing and never
+// blocks on I/O: it claims a slot in a fixed-size lock-free ring and
+// returns. A background thread drains the ring and writes whole batches,
+// flushing once per batch (Info and Debug to stdout, Warning and Error to
+// stderr). When the ring is full, messages are dropped and counted rather
+// than stalling the caller. Under systemd (JOURNAL_STREAM set) lines carry
+// "<N>" priority prefixes so journald records the level.
+class Logger {
+public:
+    // Process-wide instance. Its level starts from PODRADIO_LOG_LEVEL
+    // (debug, info, warning, error; default info). Pending lines are written at exit.
+    static Logger& global();
+
+    explicit Logger(size_t capacity = 1024);
+    ~Logger();
+
+    Logger(const Logger&) = delete;
+    Logger& operator=(const Logger&) = delete;
+
+    void setLevel(LogLevel level) { level_.store(static_cast<int>(level), std::memory_order_relaxed); }
+    LogLevel getLevel() const { return static_cast<LogLevel>(level_.load(std::memory_order_relaxed)); }
+    bool enabled(LogLevel level) const {
+        return static_cast<int>(level) >= level_.load(std::memory_order_relaxed);
+    }
+
+    void log(LogLevel level, std::string message);
+
+    // Block until everything logged so far has been written
+    void flush();
+
+    // Stop the sink thread after writing what's queued; later messages are written synchronously
+    void shutdown();
+
+    uint64_t getDroppedCount() const { return dropped_.load(std::memory_order_relaxed); }
+
+    static bool parseLevel(const std::string& name, LogLevel& level);
+
+private:
+    struct Slot {
+        std::atomic<size_t> sequence{0};
+        LogLevel level = LogLevel::Info;
+        std::string message;
+    };
+
+    bool tryPush(LogLevel level, std::string& message);
+    bool tryPop(LogLevel& level, std::string& message); // Sink thread only
+    void sinkLoop();
+    size_t drain();
+    void write(LogLevel level, const std::string& message, std::string& out, std::string& err) const;
+
+    std::unique_ptr<Slot[]> slots_;
+    size_t mask_;
+    std::atomic<size_t> enqueuePos_{0};
+    size_t dequeuePos_ = 0;
+
+    std::atomic<int> level_;
+    std::atomic<uint64_t> dropped_{0};
+    uint64_t reportedDropped_ = 0; // Sink thread only
+    bool journalPrefixes_;
+
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable drained_;
+    std::atomic<bool> sleeping_{false};
+    std::atomic<size_t> written_{0};   // Slots consumed so far
+    std::atomic<bool> stopping_{false};
+    std::mutex writeMutex_;            // Orders the sink's writes against post-shutdown ones
+    std::thread thread_;
+};
+
+// Collects one line with operator<< and hands it to the logger when destroyed
+class LogLine {
+public:
+    explicit LogLine(LogLevel level) : level_(level) {}
+    ~LogLine() { Logger::global().log(level_, stream_.str()); }
+
+    template <typename T>
+    LogLine& operator<<(const T& value) {
+        stream_ << value;
+        return *this;
+    }
+
+private:
+    LogLevel level_;
+    std::ostringstream stream_;
+};
+
+} // namespace core
+} // namespace podradio
+
+// Usage: LOG_INFO << "Added podcast: " << name;  Arguments aren't evaluated below the current level.
+#define PODRADIO_LOG(level) \
+    if (!::podradio::core::Logger::global().enabled(level)) {} else ::podradio::core::LogLine(level)
+#define LOG_DEBUG PODRADIO_LOG(::podradio::core::LogLevel::Debug)
+#define LOG_INFO PODRADIO_LOG(::podradio::core::LogLevel::Info)
+#define LOG_WARN PODRADIO_LOG(::podradio::core::LogLevel::Warning)
+#define LOG_ERROR PODRADIO_LOG(::podradio::core::LogLevel::Error)
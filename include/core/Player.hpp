@@ -2,33 +2,188 @@
 #define PODRADIO_CORE_PLAYER_HPP
 
 #include "core/PodcastFeed.hpp"
+#include "core/PositionStore.hpp"
+#include "core/ResolvedUrlCache.hpp"
+#include "core/ThreadPool.hpp"
+#include "core/VlcInstance.hpp"
 #include <vlc/vlc.h>
 #include <string>
+#include <vector>
+#include <array>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <functional>
+#include <optional>
+#include <chrono>
+#include <unordered_set>
 
 namespace podradio {
 namespace core {
 
+// Snapshot of what the player is doing, maintained from libvlc events
+struct PlaybackStatus {
+    std::string state = "stopped"; // opening, buffering, playing, paused, stopped, ended, error
+    int64_t positionMs = 0;
+    int64_t lengthMs = 0;
+    float buffering = 0.0f;        // Percent of the input cache filled
+};
+
 class Player {
 public:
-    Player();
+    // Invoked once playback of a playAsync() request has begun (success) or
+    // failed to begin. Runs on a libvlc thread, or on the thread whose stop()
+    // or newer request ended it, never under Player's locks. Don't call
+    // back into Player from it.
+    using StartCallback = std::function<void(bool success, const std::string& error)>;
+    // Returns true once the caller no longer wants a pending playAsync() to start
+    using CancelCheck = std::function<bool()>;
+
+    // Shares the process-wide libvlc instance; profile names a CachingProfile.
+    // Cheap: libvlc is initialized on the first play or preload, or by warmUp().
+    explicit Player(const std::string& cachingProfile = "default");
     ~Player();
 
+    // Applies to media opened from now on. Throws on an unknown profile name.
+    void setCachingProfile(const std::string& name);
+    const std::string& getCachingProfile() const { return caching_profile_; }
+
+    // Blocks until VLC reports playback or an error (up to 5 seconds)
     void play(const std::string& url);
+    // Same, resuming where the episode was left off when a position store is set
+    void play(const Episode& episode);
+
+    // Start playback without waiting. onStarted fires as soon as VLC reports
+    // the Playing state, or with an error if the media fails first or a
+    // newer request supersedes this one. Throws if the media can't be queued.
+    // cancelled is checked again under the control lock right before the
+    // media is swapped in, so a pause or stop issued while redirects were
+    // resolving wins; a cancelled request reports failure through onStarted.
+    void playAsync(const std::string& url, StartCallback onStarted, CancelCheck cancelled = nullptr);
+    void playAsync(const Episode& episode, StartCallback onStarted, CancelCheck cancelled = nullptr);
     void playPodcastFeed(const std::string& feedUrl);
     void pause();
     void stop();
     bool isPlaying() const;
 
+    PlaybackStatus getStatus() const;
+
+    // Initialize libvlc in the background so the first play doesn't wait
+    // for the plugin scan. Failures are reported again by that play.
+    void warmUp();
+
+    // Called from a libvlc thread whenever the status changes (often several
+    // times a second while playing); keep it cheap and don't call into Player
+    void setOnStatusChanged(std::function<void(const PlaybackStatus&)> callback);
+
+    // Maps an episode URL to a downloaded local file, or "" to stream it.
+    // When it returns a path, play() opens the file instead of the network
+    // stream. Install before the first play; it is called without locks held.
+    void setLocalMediaLookup(std::function<std::string(const std::string& url)> lookup) {
+        local_media_lookup_ = std::move(lookup);
+    }
+
+    // Track playback positions of episodes played by guid and resume them
+    // from there. Positions are recorded on libvlc time ticks; the store
+    // batches the writes. Install before the first play.
+    void setPositionStore(std::shared_ptr<PositionStore> store) { position_store_ = std::move(store); }
+
+    // Send audio to a specific output device (a libvlc device id such as an
+    // ALSA or PulseAudio sink name) instead of the system default. Install
+    // before the first play.
+    void setAudioDevice(const std::string& device) { audio_device_ = device; }
+    const std::string& getAudioDevice() const { return audio_device_; }
+
+    // Use a redirect cache shared with other players, so a URL resolved for
+    // one zone is instant in the others. Install before the first play.
+    void shareResolvedUrls(std::shared_ptr<ResolvedUrlCache> cache) { resolved_urls_ = std::move(cache); }
+
+    // Resolve redirects for url in the background so a later play() of the
+    // same URL can hand VLC the final media URL immediately
+    void prefetchMediaUrl(const std::string& url);
+
+    // Open and pre-buffer urls (typically the neighbouring subscriptions'
+    // latest episodes) on paused standby players. A later play() of one of
+    // them swaps the standby in instead of connecting and buffering afresh.
+    // Slots holding URLs no longer listed are recycled.
+    void preload(const std::vector<std::string>& urls);
+
 private:
+    struct PreloadSlot {
+        libvlc_media_player_t* player = nullptr;
+        std::string url;                // Cleaned URL being preloaded, empty when free
+        std::atomic<bool> ready{false}; // Buffered and paused at the start
+    };
+    static constexpr size_t kPreloadSlots = 2;
+
+    static void handleStandbyEvent(const libvlc_event_t* event, void* userData);
+    void prepareSlot(PreloadSlot* slot, const std::string& url);
+    bool hasPreloaded(const std::string& cleaned_url);
+    bool swapInPreloaded(const std::string& cleaned_url); // Caller holds control_mutex_
+    // media_url is a URL, or a file system path when isLocalFile is set.
+    // A non-zero startMs opens the media at that offset.
+    libvlc_media_t* createMedia(const std::string& media_url, bool isLocalFile = false, int64_t startMs = 0);
+    void attachEvents(libvlc_media_player_t* player, bool standby, void* userData);
+    void detachEvents(libvlc_media_player_t* player, bool standby, void* userData);
+    void submitBackground(std::function<void()> task);
+    // Create vlc_ and player_ once; throws if libvlc can't be initialized.
+    // Callers must not hold control_mutex_.
+    void ensureVlc();
+    void configureOutput(libvlc_media_player_t* player);
+
+    static void handleVlcEvent(const libvlc_event_t* event, void* userData);
+    void completeStart(bool success, const std::string& error);
+    // Removes the pending start callback and counts its outcome; the caller
+    // invokes it once control_mutex_ is released
+    StartCallback takePendingStart(bool success);
+    void updateStatus(const std::function<void(PlaybackStatus&)>& change);
+    void dumpMediaStats();
+    StartCallback stopLocked(); // Returns the interrupted start callback, if any
+    void recordBytesRead(libvlc_media_player_t* player);
+    void playAndWait(const std::string& url, const std::string& guid);
+    void startPlayback(const std::string& url, const std::string& guid, StartCallback onStarted,
+                       const CancelCheck& cancelled = nullptr);
+    void recordPosition(bool finished);
+
     std::string resolveMediaUrl(const std::string& url);
+    std::optional<std::string> followRedirects(const std::string& url);
     std::string getStateString(libvlc_state_t state);
 
-    libvlc_instance_t* vlc_;
-    libvlc_media_player_t* player_;
+    std::shared_ptr<libvlc_instance_t> vlc_;
+    std::string caching_profile_;
+    std::vector<std::string> media_options_;
+    std::once_flag vlc_once_;
+    libvlc_media_player_t* player_;    // Null until ensureVlc(); guarded by control_mutex_
     libvlc_media_t* media_;
-    bool playing_;
+    std::atomic<bool> playing_;
+    mutable std::mutex control_mutex_; // Serializes playback control and player_ swaps
     PodcastFeed podcast_feed_;
     Episode current_episode_;
+
+    std::function<std::string(const std::string&)> local_media_lookup_;
+    std::shared_ptr<PositionStore> position_store_;
+    std::string audio_device_;
+
+    // Event-driven status and its observer
+    mutable std::mutex status_mutex_;
+    PlaybackStatus status_;
+    std::string tracked_guid_; // Episode whose position is recorded, empty for plain URLs
+    std::function<void(const PlaybackStatus&)> on_status_changed_;
+
+    // Pending playAsync() completion, fired from the VLC event thread
+    std::mutex start_mutex_;
+    StartCallback pending_start_;
+    std::chrono::steady_clock::time_point start_requested_; // For time-to-first-audio
+
+    // Redirect resolution
+    std::shared_ptr<ResolvedUrlCache> resolved_urls_;
+    std::mutex resolver_mutex_;
+    std::unordered_set<std::string> resolving_;
+    std::unique_ptr<ThreadPool> resolver_pool_; // Created on first prefetch
+
+    // Standby players for gapless skipping
+    std::mutex preload_mutex_;
+    std::array<PreloadSlot, kPreloadSlots> preload_slots_;
 };
 
 } // namespace core
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "core/Player.hpp"
+#include "core/ResolvedUrlCache.hpp"
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace podradio {
+namespace core {
+
+// Named playback zones served by one process, each an independent Player
+// typically bound to its own audio output. Players in a registry share the
+// process-wide libvlc instance, the HTTP session pool and one redirect
+// cache; feeds come from the FeedManager they're used with. Zones are
+// never removed, so references handed out stay valid for the registry's
+// lifetime.
+class PlayerRegistry {
+public:
+    static constexpr const char* kDefaultZone = "main";
+
+    explicit PlayerRegistry(const std::string& cachingProfile = "default");
+
+    PlayerRegistry(const PlayerRegistry&) = delete;
+    PlayerRegistry& operator=(const PlayerRegistry&) = delete;
+
+    // Create a zone playing to audioDevice ("" for the system default).
+    // Throws std::runtime_error if the name is empty or already taken.
+    Player& add(const std::string& zone, const std::string& audioDevice = "");
+
+    // nullptr for unknown zones; an empty name means the default zone
+    Player* find(const std::string& zone) const;
+
+    // The first zone added, created as kDefaultZone if there is none yet
+    Player& getDefault();
+    std::string getDefaultName() const;
+
+    std::vector<std::string> getZoneNames() const;
+    size_t size() const;
+
+    // Applies to every zone, e.g. to install a position store. Don't add
+    // zones from inside fn.
+    void forEach(const std::function<void(const std::string& zone, Player& player)>& fn) const;
+
+    // Applies to existing zones and those added later
+    void setCachingProfile(const std::string& name);
+
+private:
+    struct Zone {
+        std::string name;
+        std::unique_ptr<Player> player;
+    };
+
+    Player& addLocked(const std::string& zone, const std::string& audioDevice);
+
+    std::string cachingProfile_;
+    std::shared_ptr<ResolvedUrlCache> resolvedUrls_;
+    std::vector<Zone> zones_; // In creation order; the front one is the default
+    mutable std::mutex mutex_;
+};
+
+} // namespace core
+} // namespace podradio
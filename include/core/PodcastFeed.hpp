@@ -1,20 +1,33 @@
 #pragma once
 
+#include "core/EpisodeStore.hpp"
 #include <string>
 #include <vector>
 #include <memory>
-#include <pugixml.hpp>
+#include <functional>
+#include <string_view>
 
 namespace podradio {
 namespace core {
 
-struct Episode {
-    std::string title;
-    std::string description;
-    std::string url;
-    std::string pubDate;
-    std::string duration;
-    std::string guid;
+// HTTP cache validators used for conditional GET requests
+struct FeedValidators {
+    std::string etag;
+    std::string lastModified;
+};
+
+struct RssItem;
+class RssStreamParser;
+class ThreadPool;
+class ItemBatch;
+
+// Controls how much of a feed the streaming parser reads
+struct FeedLoadOptions {
+    size_t maxItems = 0;                                // Stop after this many episodes (0 = all)
+    std::function<bool(std::string_view)> isKnownGuid;  // Stop at the first already-seen guid
+    // Post-process items in chunks on this pool while parsing continues;
+    // results keep feed order. Ignored when maxItems is set.
+    ThreadPool* parsePool = nullptr;
 };
 
 class PodcastFeed {
@@ -25,11 +38,20 @@ public:
     // Load and parse a podcast feed from a URL
     void loadFromUrl(const std::string& url);
 
+    // Conditional variant: sends If-None-Match/If-Modified-Since from the given
+    // validators. Returns false (leaving the feed untouched) on 304 Not Modified;
+    // any other non-200 status throws, also without touching the feed.
+    bool loadFromUrl(const std::string& url, const FeedValidators& validators,
+                     const FeedLoadOptions& options = FeedLoadOptions());
+
+    // Parse a feed document that is already in memory
+    void loadFromString(const std::string& xml, const FeedLoadOptions& options = FeedLoadOptions());
+
     // Get the latest episode
     Episode getLatestEpisode() const;
 
-    // Get all episodes
-    const std::vector<Episode>& getEpisodes() const { return episodes_; }
+    // Get all episodes (views into the feed's arena, no copies)
+    const EpisodeStore& getEpisodes() const { return episodes_; }
 
     // Get feed metadata
     std::string getTitle() const { return title_; }
@@ -37,17 +59,31 @@ public:
     std::string getLink() const { return link_; }
     std::string getLanguage() const { return language_; }
 
+    // True when the last parse stopped at a guid reported as known, i.e. the
+    // episodes hold only items newer than the caller's existing list
+    bool reachedKnownGuid() const { return reachedKnownGuid_; }
+
+    // Validators returned by the server on the last successful fetch
+    const FeedValidators& getValidators() const { return validators_; }
+
+    // Pick the playable URL of an item (enclosure, media:content, link, guid);
+    // empty when it has none. Touches no feed state, so any thread may call it.
+    static std::string extractAudioUrl(const RssItem& item);
+
 private:
-    void parseFeed(const std::string& xml);
-    std::string extractAudioUrl(const pugi::xml_node& item) const;
-    std::string cleanAndValidateUrl(const std::string& url) const;
+    void parseFeed(const std::string& xml, const FeedLoadOptions& options);
+    void resetFeed();
+    bool addItem(RssItem& item, const FeedLoadOptions& options, ItemBatch* batch);
+    void mergeBatch(ItemBatch& batch);
+    void finishParse(RssStreamParser& parser);
     
     std::string title_;
     std::string description_;
     std::string link_;
     std::string language_;
-    std::vector<Episode> episodes_;
-    pugi::xml_document doc_;
+    EpisodeStore episodes_;
+    FeedValidators validators_;
+    bool reachedKnownGuid_ = false;
 };
 
 } // namespace core
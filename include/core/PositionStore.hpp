@@ -0,0 +1,55 @@
+#pragma once
+
+#include "core/DebouncedWriter.hpp"
+#include <string>
+#include <mutex>
+#include <cstdint>
+#include <unordered_map>
+
+namespace podradio {
+namespace core {
+
+// Remembers how far into each episode playback got, keyed by Episode::guid.
+// update() is meant to be called on every libvlc time tick: it only touches
+// memory, and the file is rewritten in batches (at most every few seconds
+// while playing). All methods are thread-safe.
+class PositionStore {
+public:
+    explicit PositionStore(const std::string& path = "positions.json");
+
+    PositionStore(const PositionStore&) = delete;
+    PositionStore& operator=(const PositionStore&) = delete;
+
+    // Record the playback position; lengthMs may be 0 while still unknown
+    void update(const std::string& guid, int64_t positionMs, int64_t lengthMs);
+
+    // Forget the episode so the next play starts from the beginning
+    void markFinished(const std::string& guid);
+
+    // Where to resume the episode in milliseconds, or 0 to start over.
+    // Backs up a few seconds for context; positions near either end count as unplayed/finished.
+    int64_t getResumePosition(const std::string& guid) const;
+
+    size_t size() const;
+
+    // Write pending changes now (e.g. before exiting)
+    void flush() { writer_.flush(); }
+
+private:
+    struct Entry {
+        int64_t positionMs = 0;
+        int64_t lengthMs = 0;
+        int64_t updatedAt = 0;  // Milliseconds since epoch, for pruning
+    };
+
+    void load();
+    void pruneLocked();
+    std::string serialize() const;
+
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, Entry> entries_;
+    DebouncedWriter writer_;
+};
+
+} // namespace core
+} // namespace podradio
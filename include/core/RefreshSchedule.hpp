@@ -0,0 +1,108 @@
+#pragma once
+
+#include "core/FeedCache.hpp"
+#include "core/SubscriptionSnapshot.hpp"
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <queue>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace podradio {
+namespace core {
+
+struct RefreshOptions {
+    size_t workerCount = 8;                 // Total concurrent feed fetches
+    size_t perHostLimit = 2;                // Concurrent fetches against a single host
+    std::chrono::seconds interval{30 * 60}; // Fixed rounds, and feeds whose cadence is unknown
+    double jitter = 0.1;                    // Random +/- fraction applied to every delay
+
+    // Adaptive scheduling checks each feed according to how often it publishes
+    bool adaptive = true;
+    std::chrono::seconds minInterval{15 * 60};      // Fastest check rate for any feed
+    std::chrono::seconds maxInterval{24 * 60 * 60}; // Slowest check rate for a healthy feed
+    std::chrono::seconds maxBackoff{24 * 60 * 60};  // Cap on the retry delay of a failing feed
+};
+
+// Decides when each enabled subscription is next worth fetching. A feed's
+// publish cadence is learned from the pubDates in its cached episodes and
+// refined by how often checks come back with nothing new; failing feeds back
+// off exponentially. Due feeds are handed out most-likely-changed first.
+// All methods are safe to call from multiple threads.
+class RefreshSchedule {
+public:
+    using Clock = std::chrono::system_clock;
+
+    explicit RefreshSchedule(const RefreshOptions& options = RefreshOptions());
+
+    // Track exactly the enabled subscriptions of snapshot. On the first
+    // sync each feed is due minInterval after its last update; feeds that
+    // appear in later syncs are due at once.
+    void sync(const SubscriptionSnapshot& snapshot, Clock::time_point now);
+
+    // Removes every due subscription, highest expected freshness gain first.
+    // Each one stays out of the schedule until its outcome is recorded.
+    std::vector<SubscriptionSnapshot::Item> takeDue(Clock::time_point now);
+
+    void recordSuccess(const std::string& subscriptionId, const FeedCacheEntry& entry, Clock::time_point now);
+    void recordFailure(const std::string& subscriptionId, Clock::time_point now);
+
+    // Earliest scheduled check, or time_point::max() when nothing is scheduled
+    Clock::time_point nextDue() const;
+
+    size_t size() const;
+
+    // Introspection; nullopt for unknown subscriptions or feeds without enough dated episodes
+    std::optional<std::chrono::seconds> getPublishInterval(const std::string& subscriptionId) const;
+    std::optional<Clock::time_point> getNextCheck(const std::string& subscriptionId) const;
+
+    // RFC 822 dates as used by RSS pubDate, plus the ISO 8601 form some feeds emit
+    static std::optional<Clock::time_point> parsePubDate(std::string_view text);
+
+    // Median gap between the newest dated episodes
+    static std::optional<std::chrono::seconds> estimatePublishInterval(const EpisodeStore& episodes);
+
+private:
+    struct FeedState {
+        SubscriptionSnapshot::Item subscription;
+        std::optional<std::chrono::seconds> publishInterval;
+        Clock::time_point lastPublished{};
+        Clock::time_point lastChecked{};
+        Clock::time_point nextCheck{};
+        std::string newestGuid;       // Front episode at the last check
+        double unchangedRate = 0.5;   // Moving average of checks that found nothing new
+        uint32_t failures = 0;        // Consecutive failed checks
+        uint64_t generation = 0;      // Invalidates stale heap entries
+        bool inFlight = false;
+        bool observed = false;        // At least one successful check recorded
+    };
+
+    struct Pending {
+        Clock::time_point due;
+        std::string subscriptionId;
+        uint64_t generation;
+
+        bool operator>(const Pending& other) const { return due > other.due; }
+    };
+
+    void scheduleLocked(const std::string& subscriptionId, FeedState& state, Clock::time_point due);
+    void discardStaleLocked() const;
+    std::chrono::seconds checkIntervalLocked(const FeedState& state, Clock::time_point now) const;
+    double freshnessGain(const FeedState& state, Clock::time_point now) const;
+    Clock::duration jittered(Clock::duration delay) const;
+
+    RefreshOptions options_;
+    std::unordered_map<std::string, FeedState> feeds_;
+    bool synced_ = false;
+    // Min-heap on due time; entries whose generation no longer matches are skipped
+    mutable std::priority_queue<Pending, std::vector<Pending>, std::greater<Pending>> heap_;
+    mutable std::mutex mutex_;
+};
+
+} // namespace core
+} // namespace podradio
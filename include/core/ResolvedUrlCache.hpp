@@ -0,0 +1,37 @@
+#pragma once
+
+#include <string>
+#include <chrono>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+
+namespace podradio {
+namespace core {
+
+// Thread-safe TTL cache mapping episode URLs to their final media URL after
+// following tracking-prefix redirect chains (podtrac, megaphone, ...).
+class ResolvedUrlCache {
+public:
+    explicit ResolvedUrlCache(std::chrono::seconds ttl = std::chrono::hours(1), size_t maxEntries = 1024);
+
+    std::optional<std::string> lookup(const std::string& url);
+    void store(const std::string& url, const std::string& resolvedUrl);
+    void clear();
+
+private:
+    struct Entry {
+        std::string resolvedUrl;
+        std::chrono::steady_clock::time_point expiresAt;
+    };
+
+    void evictExpired(std::chrono::steady_clock::time_point now);
+
+    std::chrono::seconds ttl_;
+    size_t maxEntries_;
+    std::unordered_map<std::string, Entry> entries_;
+    std::mutex mutex_;
+};
+
+} // namespace core
+} // namespace podradio
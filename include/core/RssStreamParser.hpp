@@ -0,0 +1,91 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <functional>
+
+namespace podradio {
+namespace core {
+
+// Raw fields of one <item>, before audio URL selection
+struct RssItem {
+    std::string title;
+    std::string description;      // Left XML-escaped when descriptionEncoded is set
+    bool descriptionEncoded = false;
+    std::string pubDate;
+    std::string duration;
+    std::string guid;
+    std::string link;
+    std::string enclosureUrl;
+    std::string enclosureType;
+    std::string mediaUrl;
+    std::string mediaType;
+
+    // Reset all fields while keeping their allocated capacity
+    void clear();
+};
+
+struct RssChannel {
+    std::string title;
+    std::string description;
+    std::string link;
+    std::string language;
+};
+
+// Incremental SAX-style RSS parser. Bytes can be fed in arbitrary chunks
+// (e.g. straight from an HTTP body callback); each completed <item> is
+// handed to the callback and then discarded, so no document tree is kept.
+class RssStreamParser {
+public:
+    // Return false from the handler to stop parsing early
+    using ItemHandler = std::function<bool(RssItem& item)>;
+
+    explicit RssStreamParser(ItemHandler onItem);
+
+    // Feed the next chunk. Returns false once parsing has stopped, either
+    // because the handler asked to or because the document is malformed.
+    bool feed(std::string_view chunk);
+
+    // Signal end of input. Returns false if the document is malformed or
+    // truncated (unless parsing was stopped early by the handler).
+    bool finish();
+
+    bool stopped() const { return stopped_; }
+    bool hasError() const { return !error_.empty(); }
+    const std::string& getError() const { return error_; }
+
+    bool foundChannel() const { return sawChannel_; }
+    const RssChannel& getChannel() const { return channel_; }
+
+    // Expand XML entities and character references
+    static std::string decodeEntities(std::string_view text);
+
+private:
+    bool processPending();
+    void handleText(std::string_view text, bool raw);
+    void openElement(std::string_view name, std::string_view attributes, bool selfClosing);
+    void closeElement(std::string_view name);
+    void fail(const std::string& message);
+
+    ItemHandler onItem_;
+    std::string pending_;
+    size_t resumeScan_;
+
+    std::vector<std::string> stack_;
+    size_t channelDepth_;
+    size_t itemDepth_;
+    std::string* capture_;
+    size_t captureDepth_;
+    bool captureRaw_;       // Capturing the item description without decoding
+    bool captureLiteral_;   // Raw capture already holds literal '&' from CDATA
+
+    RssChannel channel_;
+    RssItem item_;
+    bool sawChannel_;
+    bool stopped_;
+    std::string error_;
+};
+
+} // namespace core
+} // namespace podradio
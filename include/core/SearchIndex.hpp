@@ -0,0 +1,121 @@
+#pragma once
+
+#include "core/FeedCache.hpp"
+#include "core/SubscriptionSnapshot.hpp"
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace podradio {
+namespace core {
+
+enum class SearchScope { All, Podcasts, Episodes };
+
+struct SearchQuery {
+    std::string text;
+    SearchScope scope = SearchScope::All;
+    std::string subscriptionId; // Only this podcast's episodes when set
+    size_t offset = 0;
+    size_t limit = 20;
+};
+
+struct SearchHit {
+    std::string subscriptionId;
+    // Episode hits only: the cache entry and the episode's position in it.
+    // The entry is shared, so the episode stays readable after a refresh.
+    std::shared_ptr<const FeedCacheEntry> entry;
+    size_t episodeIndex = 0;
+    uint32_t score = 0;
+
+    bool isEpisode() const { return entry != nullptr; }
+};
+
+struct SearchResults {
+    std::vector<SearchHit> hits; // The requested page
+    size_t total = 0;            // Matches across all pages
+};
+
+// In-memory inverted index over subscription names and descriptions, and
+// over the titles and descriptions of cached episodes. Terms are lowercase
+// words; every query word must match, and the last one also matches as a
+// prefix so results can follow typing. Title matches rank above
+// description matches. Episode text isn't copied: documents refer to the
+// shared cache entries. Updates are incremental by episode guid, so a
+// refresh only tokenizes new episodes. Safe to use from multiple threads.
+class SearchIndex {
+public:
+    // Index new and renamed subscriptions, and drop those (and their
+    // episodes) no longer in snapshot
+    void syncSubscriptions(const SubscriptionSnapshot& snapshot);
+
+    // Replace the indexed episodes of a subscription with those in entry
+    // (nullptr indexes none). Ignored for subscriptions not synced yet.
+    void setEpisodes(const std::string& subscriptionId, std::shared_ptr<const FeedCacheEntry> entry);
+
+    // Same, but only if the subscription's episodes were never set, so an
+    // older entry can't replace one a refresh has published meanwhile
+    void fillEpisodes(const std::string& subscriptionId, std::shared_ptr<const FeedCacheEntry> entry);
+
+    // Synced subscriptions whose episodes were never set
+    std::vector<std::string> getUnindexedSubscriptions() const;
+
+    SearchResults search(const SearchQuery& query) const;
+
+    size_t getTermCount() const;
+    size_t getDocumentCount() const;
+
+    // Lowercase words of text; markup skips <tags>
+    static std::vector<std::string> tokenize(std::string_view text, bool markup = false);
+
+private:
+    struct Posting {
+        uint32_t document;
+        uint32_t weight;
+    };
+
+    struct Document {
+        std::string subscriptionId;
+        size_t episodeIndex = 0; // Episodes only
+        bool episode = false;
+        size_t fingerprint = 0;      // Episodes: detects edited text under an unchanged guid
+        std::vector<uint32_t> terms; // Distinct term ids, for removal
+    };
+
+    struct Owner {
+        std::string name;
+        std::string description;
+        uint32_t document = 0; // The subscription's own document
+        bool episodesIndexed = false;
+        std::shared_ptr<const FeedCacheEntry> entry;
+        std::unordered_map<std::string, uint32_t> episodes; // Guid (or URL) to document
+    };
+
+    // Callers hold mutex_ exclusively
+    uint32_t addDocument(Document document, const std::unordered_map<std::string, uint32_t>& weights);
+    void removeDocument(uint32_t id);
+    void removeOwner(std::unordered_map<std::string, Owner>::iterator owner);
+    void replaceEpisodes(Owner& owner, const std::string& subscriptionId, std::shared_ptr<const FeedCacheEntry> entry);
+    void indexSubscription(const std::string& id, Owner& owner);
+    uint32_t indexEpisode(const std::string& subscriptionId, const EpisodeView& episode, size_t index);
+    uint32_t termId(const std::string& term);
+
+    // Callers hold mutex_. Ids of the terms word matches; its completions when prefix is set.
+    std::vector<uint32_t> termsFor(const std::string& word, bool prefix) const;
+
+    std::map<std::string, uint32_t> terms_; // Ordered for prefix lookups
+    std::vector<std::vector<Posting>> postings_; // By term id, sorted by document
+    std::vector<std::map<std::string, uint32_t>::iterator> termEntries_; // By term id
+    std::vector<uint32_t> freeTerms_; // Ids of terms whose last posting went away
+    std::unordered_map<uint32_t, Document> documents_;
+    uint32_t nextDocument_ = 0; // Ids only grow, so new postings append in order
+    std::unordered_map<std::string, Owner> owners_; // By subscription id
+    mutable std::shared_mutex mutex_;
+};
+
+} // namespace core
+} // namespace podradio
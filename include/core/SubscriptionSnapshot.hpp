@@ -0,0 +1,59 @@
+#pragma once
+
+#include "core/Subscription.hpp"
+#include <vector>
+#include <string>
+#include <memory>
+#include <unordered_map>
+
+namespace podradio {
+namespace core {
+
+// Lookup tables from id, name and feed URL to list positions.
+// The first subscription carrying a key wins.
+struct SubscriptionIndex {
+    std::unordered_map<std::string, size_t> byId;
+    std::unordered_map<std::string, size_t> byName;
+    std::unordered_map<std::string, size_t> byFeedUrl;
+
+    void add(const Subscription& subscription, size_t position);
+
+    // Earliest position whose name, feed URL or id equals identifier, or -1
+    int find(const std::string& identifier) const;
+};
+
+// Immutable version of the subscription list. FeedManager publishes a new
+// snapshot for every change; readers keep whichever one they loaded for as
+// long as they need it, without locking and without copying subscriptions.
+class SubscriptionSnapshot {
+public:
+    using Ptr = std::shared_ptr<const SubscriptionSnapshot>;
+    using Item = std::shared_ptr<const Subscription>;
+
+    SubscriptionSnapshot();
+    // Builds the index from items
+    explicit SubscriptionSnapshot(std::vector<Item> items);
+    // Reuses index; only valid when no id, name or feed URL changed
+    SubscriptionSnapshot(std::vector<Item> items, std::shared_ptr<const SubscriptionIndex> index);
+
+    size_t size() const { return items_.size(); }
+    bool empty() const { return items_.empty(); }
+    const Subscription& operator[](size_t position) const { return *items_[position]; }
+
+    // Shared handle that stays valid after newer snapshots replace this one
+    const Item& at(size_t position) const { return items_.at(position); }
+    const std::vector<Item>& items() const { return items_; }
+    const std::shared_ptr<const SubscriptionIndex>& index() const { return index_; }
+
+    int find(const std::string& identifier) const { return index_->find(identifier); }
+
+    std::vector<Item>::const_iterator begin() const { return items_.begin(); }
+    std::vector<Item>::const_iterator end() const { return items_.end(); }
+
+private:
+    std::vector<Item> items_;
+    std::shared_ptr<const SubscriptionIndex> index_;
+};
+
+} // namespace core
+} // namespace podradio
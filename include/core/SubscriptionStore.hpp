@@ -0,0 +1,27 @@
+#pragma once
+
+#include "core/SubscriptionSnapshot.hpp"
+#include <string>
+#include <vector>
+
+namespace podradio {
+namespace core {
+
+// Compact binary form of the subscription list, the alternative to the JSON
+// file for fast cold starts. The file is memory-mapped and decoded in a
+// single pass with no tokenizing: a header followed by length-prefixed
+// fields, little-endian, one record per subscription.
+class SubscriptionStore {
+public:
+    // True for paths FeedManager should store in this format (".bin")
+    static bool isBinaryPath(const std::string& path);
+
+    static std::string encode(const SubscriptionSnapshot& snapshot, int currentIndex);
+
+    // False if the file is missing, truncated or not in this format
+    static bool load(const std::string& path, std::vector<SubscriptionSnapshot::Item>& items, int& currentIndex);
+    static bool decode(const char* data, size_t size, std::vector<SubscriptionSnapshot::Item>& items, int& currentIndex);
+};
+
+} // namespace core
+} // namespace podradio
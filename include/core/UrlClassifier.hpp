@@ -0,0 +1,26 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+namespace podradio {
+namespace core {
+
+// URL handling shared by feed parsing and playback. Pattern tables are built
+// at compile time, and URLs that are already in canonical form skip the full
+// ada parse, which matters when large feeds are parsed.
+class UrlClassifier {
+public:
+    // Trimmed, normalized http(s) URL, or "" if url isn't one
+    static std::string clean(std::string_view url);
+
+    // A known audio extension in the path or query, or a known podcast
+    // hosting/tracking domain anywhere in the URL
+    static bool looksLikeAudio(std::string_view url);
+
+    // True when url is an http(s) URL that ada would return unchanged
+    static bool isNormalizedHttpUrl(std::string_view url);
+};
+
+} // namespace core
+} // namespace podradio
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <vlc/vlc.h>
+#include <string>
+#include <vector>
+#include <memory>
+
+namespace podradio {
+namespace core {
+
+// Buffering trade-off applied to each media a Player opens
+struct CachingProfile {
+    std::string name;
+    int networkCachingMs;
+    int fileCachingMs;
+    int liveCachingMs;
+    int networkTimeoutMs;
+
+    // Per-media libvlc options (":network-caching=..." etc.)
+    std::vector<std::string> mediaOptions() const;
+
+    // "default", "low-latency" or "high-loss"; nullptr for unknown names
+    static const CachingProfile* find(const std::string& name);
+    static const CachingProfile& standard();
+    static const std::vector<CachingProfile>& all();
+};
+
+// Process-wide libvlc instance. libvlc_new scans and initializes the plugin
+// set, which costs hundreds of milliseconds, so it is created once on first
+// use and shared by every media player until the last owner releases it.
+class VlcInstance {
+public:
+    // Throws std::runtime_error if libvlc can't be initialized
+    static std::shared_ptr<libvlc_instance_t> get();
+};
+
+} // namespace core
+} // namespace podradio
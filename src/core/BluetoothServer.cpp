@@ -1,43 +1,153 @@
 #include "core/BluetoothServer.hpp"
-#include <iostream>
+#include "core/Logger.hpp"
+#include "core/Metrics.hpp"
 #include <sstream>
 #include <cstring>
 #include <unistd.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <errno.h>
 #include <fcntl.h>
 #include <chrono>
+#include <algorithm>
+#include <iterator>
+#include <unordered_map>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
 
 namespace podradio {
 namespace core {
 
-BluetoothServer::BluetoothServer(FeedManager& feedManager, Player& player, int port)
-    : feedManager_(feedManager), player_(player), port_(port),
+namespace {
+
+const int kMaxEvents = 16;
+const size_t kMaxMessageBytes = 64 * 1024; // Larger unterminated input is a broken client
+const int kDefaultPushIntervalMs = 1000;
+const int kMinPushIntervalMs = 200;
+const size_t kReadChunkBytes = 4096;
+const size_t kMaxQueuedBytes = 256 * 1024;    // Beyond this a client is too slow to keep
+const size_t kDroppableQueueBytes = 16 * 1024; // Skip droppable pushes above this backlog
+const int kMaxIovecs = 16;
+
+const char* const kListFields[] = {"index", "name", "url", "description", "enabled", "is_current"};
+
+const size_t kDefaultSearchLimit = 10;
+const size_t kMaxSearchLimit = 50; // Keeps one page well inside a few RFCOMM frames
+
+const char* const kActions[] = {
+    "add_podcast", "add_podcasts", "remove_podcast", "list_podcasts", "play_podcast", "player_control",
+    "get_status", "navigate_podcasts", "get_metrics", "search", "subscribe", "unsubscribe", "set_encoding"
+};
+
+// One latency histogram per known action, looked up once. Unknown actions
+// share one histogram so clients can't grow the registry.
+struct CommandHistograms {
+    std::unordered_map<std::string, Histogram*> byAction;
+    Histogram& unknown = MetricsRegistry::global().histogram("bluetooth.command_us.unknown");
+
+    CommandHistograms() {
+        for (const char* action : kActions) {
+            byAction.emplace(action, &MetricsRegistry::global().histogram(std::string("bluetooth.command_us.") + action));
+        }
+    }
+};
+
+CommandHistograms& commandHistograms() {
+    static CommandHistograms histograms;
+    return histograms;
+}
+
+// Time from receiving a command to sending its (final) response
+void recordCommandLatency(const std::string& action, std::chrono::steady_clock::time_point received) {
+    CommandHistograms& histograms = commandHistograms();
+    auto it = histograms.byAction.find(action);
+    Histogram& histogram = it != histograms.byAction.end() ? *it->second : histograms.unknown;
+    histogram.record(ScopedTimer::elapsedUs(received));
+}
+
+bool parseEncoding(const std::string& name, WireEncoding& encoding) {
+    if (name == "json") {
+        encoding = WireEncoding::Json;
+    } else if (name == "cbor") {
+        encoding = WireEncoding::Cbor;
+    } else if (name == "msgpack") {
+        encoding = WireEncoding::MessagePack;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+nlohmann::json decodeMessage(std::string_view message, WireEncoding encoding) {
+    switch (encoding) {
+        case WireEncoding::Cbor:
+            return nlohmann::json::from_cbor(message.begin(), message.end());
+        case WireEncoding::MessagePack:
+            return nlohmann::json::from_msgpack(message.begin(), message.end());
+        case WireEncoding::Json:
+        default:
+            return nlohmann::json::parse(message.begin(), message.end());
+    }
+}
+
+// Appends one complete frame for message to out
+void encodeMessage(const nlohmann::json& message, WireEncoding encoding, std::string& out) {
+    if (encoding == WireEncoding::Json) {
+        out += message.dump();
+        out += '\n';
+        return;
+    }
+
+    std::vector<uint8_t> payload = encoding == WireEncoding::Cbor
+        ? nlohmann::json::to_cbor(message)
+        : nlohmann::json::to_msgpack(message);
+    FrameParser::appendLengthPrefix(out, static_cast<uint32_t>(payload.size()));
+    out.append(payload.begin(), payload.end());
+}
+
+} // namespace
+
+BluetoothServer::BluetoothServer(FeedManager& feedManager, PlayerRegistry& players, int port)
+    : feedManager_(feedManager), port_(port),
       serviceName_("PodRadio Control"), serviceDescription_("PodRadio Bluetooth Control Service"),
-      serverSocket_(-1), sdpSession_(nullptr) {
+      serverSocket_(-1), sdpSession_(nullptr), epollFd_(-1), wakeupFd_(-1) {
+    // Lives as long as the server so player callbacks never see a stale fd
+    wakeupFd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+    players.getDefault(); // Always serve at least one zone
+    players.forEach([this](const std::string& name, Player& player) {
+        zones_.push_back(std::make_unique<Zone>(name, player));
+        player.setOnStatusChanged([this](const PlaybackStatus&) { notifyStatusChanged(); });
+    });
 }
 
 BluetoothServer::~BluetoothServer() {
+    for (const auto& zone : zones_) {
+        zone->player.setOnStatusChanged(nullptr);
+    }
     stop();
+    if (wakeupFd_ != -1) {
+        close(wakeupFd_);
+    }
 }
 
 bool BluetoothServer::start() {
     if (running_) {
-        std::cerr << "Bluetooth server is already running" << std::endl;
+        LOG_ERROR << "Bluetooth server is already running";
         return false;
     }
 
     // Create RFCOMM socket
     serverSocket_ = socket(AF_BLUETOOTH, SOCK_STREAM, BTPROTO_RFCOMM);
     if (serverSocket_ == -1) {
-        std::cerr << "Failed to create Bluetooth socket: " << strerror(errno) << std::endl;
+        LOG_ERROR << "Failed to create Bluetooth socket: " << strerror(errno);
         return false;
     }
 
     // Set socket options for reuse
     int opt = 1;
     if (setsockopt(serverSocket_, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt)) < 0) {
-        std::cerr << "Failed to set socket options: " << strerror(errno) << std::endl;
+        LOG_ERROR << "Failed to set socket options: " << strerror(errno);
         close(serverSocket_);
         return false;
     }
@@ -49,32 +159,55 @@ bool BluetoothServer::start() {
     addr.rc_channel = (uint8_t)port_;
 
     if (bind(serverSocket_, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
-        std::cerr << "Failed to bind Bluetooth socket: " << strerror(errno) << std::endl;
+        LOG_ERROR << "Failed to bind Bluetooth socket: " << strerror(errno);
         close(serverSocket_);
         return false;
     }
 
     // Listen for connections
     if (listen(serverSocket_, 5) < 0) {
-        std::cerr << "Failed to listen on Bluetooth socket: " << strerror(errno) << std::endl;
+        LOG_ERROR << "Failed to listen on Bluetooth socket: " << strerror(errno);
         close(serverSocket_);
         return false;
     }
 
     // Register service with SDP
     if (!registerService()) {
-        std::cerr << "Failed to register Bluetooth service" << std::endl;
+        LOG_ERROR << "Failed to register Bluetooth service";
         close(serverSocket_);
         return false;
     }
 
+    // Multiplex the listening socket and a wakeup eventfd; clients join later
+    epollFd_ = epoll_create1(EPOLL_CLOEXEC);
+    if (epollFd_ == -1 || wakeupFd_ == -1 || !setSocketNonBlocking(serverSocket_)) {
+        LOG_ERROR << "Failed to set up Bluetooth event loop: " << strerror(errno);
+        if (epollFd_ != -1) close(epollFd_);
+        epollFd_ = -1;
+        unregisterService();
+        close(serverSocket_);
+        return false;
+    }
+
+    struct epoll_event event = {};
+    event.events = EPOLLIN;
+    event.data.fd = serverSocket_;
+    epoll_ctl(epollFd_, EPOLL_CTL_ADD, serverSocket_, &event);
+    event.data.fd = wakeupFd_;
+    epoll_ctl(epollFd_, EPOLL_CTL_ADD, wakeupFd_, &event);
+
     running_ = true;
+
+    // Index cached feeds off the event loop so the first search answers at once
+    if (!commandPool_) {
+        commandPool_ = std::make_unique<ThreadPool>(2);
+    }
+    commandPool_->submit([this] { feedManager_.prepareSearch(); });
     
-    // Start server and cleanup threads
+    // Start the event loop thread
     serverThread_ = std::thread(&BluetoothServer::serverLoop, this);
-    cleanupThread_ = std::thread(&BluetoothServer::cleanupDisconnectedClients, this);
 
-    std::cout << "Bluetooth server started on channel " << port_ << std::endl;
+    LOG_INFO << "Bluetooth server started on channel " << port_;
     return true;
 }
 
@@ -83,43 +216,44 @@ void BluetoothServer::stop() {
 
     running_ = false;
 
-    // Close server socket
-    if (serverSocket_ != -1) {
-        close(serverSocket_);
-        serverSocket_ = -1;
+    // Wake the event loop; it disconnects all clients on the way out
+    uint64_t one = 1;
+    if (write(wakeupFd_, &one, sizeof(one)) < 0) {
+        LOG_ERROR << "Failed to wake Bluetooth event loop: " << strerror(errno);
     }
-
-    // Disconnect all clients
-    {
-        std::lock_guard<std::mutex> lock(clientsMutex_);
-        for (auto& client : connectedClients_) {
-            client->connected = false;
-            close(client->socket);
-            if (client->clientThread.joinable()) {
-                client->clientThread.join();
-            }
-        }
-        connectedClients_.clear();
-    }
-
-    // Wait for threads to finish
     if (serverThread_.joinable()) {
         serverThread_.join();
     }
-    if (cleanupThread_.joinable()) {
-        cleanupThread_.join();
+
+    // Drop queued commands and wait for running ones
+    if (commandPool_) {
+        commandPool_->clearPending();
+        commandPool_.reset();
+    }
+
+    // Close server socket and event loop descriptors
+    if (serverSocket_ != -1) {
+        close(serverSocket_);
+        serverSocket_ = -1;
     }
+    close(epollFd_);
+    epollFd_ = -1;
 
     // Unregister service
     unregisterService();
 
-    std::cout << "Bluetooth server stopped" << std::endl;
+    LOG_INFO << "Bluetooth server stopped";
+}
+
+int BluetoothServer::getConnectedClientCount() const {
+    std::lock_guard<std::mutex> lock(clientsMutex_);
+    return static_cast<int>(connectedClients_.size());
 }
 
 std::vector<std::string> BluetoothServer::getConnectedClients() const {
     std::lock_guard<std::mutex> lock(clientsMutex_);
     std::vector<std::string> clients;
-    for (const auto& client : connectedClients_) {
+    for (const auto& [socket, client] : connectedClients_) {
         if (client->connected) {
             clients.push_back(client->address);
         }
@@ -128,15 +262,72 @@ std::vector<std::string> BluetoothServer::getConnectedClients() const {
 }
 
 void BluetoothServer::serverLoop() {
+    struct epoll_event events[kMaxEvents];
+    int timeout = -1;
+
     while (running_) {
+        int count = epoll_wait(epollFd_, events, kMaxEvents, timeout);
+        if (count < 0) {
+            if (errno == EINTR) continue;
+            LOG_ERROR << "Bluetooth event loop failed: " << strerror(errno);
+            break;
+        }
+
+        for (int i = 0; i < count; ++i) {
+            int fd = events[i].data.fd;
+            uint32_t flags = events[i].events;
+
+            if (fd == wakeupFd_) {
+                uint64_t value;
+                while (read(wakeupFd_, &value, sizeof(value)) > 0) {}
+                continue;
+            }
+            if (fd == serverSocket_) {
+                acceptClients();
+                continue;
+            }
+
+            std::shared_ptr<BluetoothClient> client;
+            {
+                std::lock_guard<std::mutex> lock(clientsMutex_);
+                auto it = connectedClients_.find(fd);
+                if (it == connectedClients_.end()) continue;
+                client = it->second;
+            }
+
+            // Read first so a final request before hang-up is still served
+            bool open = !(flags & EPOLLIN) || readFromClient(client);
+            if (open && (flags & EPOLLOUT)) {
+                std::lock_guard<std::mutex> lock(client->writeMutex);
+                flushClient(*client);
+            }
+            if (!open || !client->connected || (flags & (EPOLLHUP | EPOLLERR | EPOLLRDHUP))) {
+                closeClient(client);
+            }
+        }
+
+        timeout = pushStatusUpdates();
+    }
+
+    closeAllClients();
+}
+
+void BluetoothServer::acceptClients() {
+    while (true) {
         struct sockaddr_rc clientAddr = {0};
         socklen_t clientAddrLen = sizeof(clientAddr);
         
         int clientSocket = accept(serverSocket_, (struct sockaddr*)&clientAddr, &clientAddrLen);
         if (clientSocket < 0) {
-            if (running_) {
-                std::cerr << "Failed to accept connection: " << strerror(errno) << std::endl;
+            if (errno != EAGAIN && errno != EWOULDBLOCK && running_) {
+                LOG_ERROR << "Failed to accept connection: " << strerror(errno);
             }
+            return;
+        }
+
+        if (!setSocketNonBlocking(clientSocket)) {
+            LOG_ERROR << "Failed to make client socket non-blocking: " << strerror(errno);
+            close(clientSocket);
             continue;
         }
 
@@ -145,19 +336,23 @@ void BluetoothServer::serverLoop() {
         ba2str(&clientAddr.rc_bdaddr, addr);
         std::string clientAddress(addr);
 
-        std::cout << "Client connected: " << clientAddress << std::endl;
+        LOG_INFO << "Client connected: " << clientAddress;
 
-        // Create client object
-        auto client = std::make_shared<BluetoothClient>(clientSocket, clientAddress);
-        
-        // Add to connected clients
+        // Create client object and add to connected clients
+        auto client = std::make_shared<BluetoothClient>(clientSocket, clientAddress, kMaxMessageBytes);
         {
             std::lock_guard<std::mutex> lock(clientsMutex_);
-            connectedClients_.push_back(client);
+            connectedClients_[clientSocket] = client;
         }
 
-        // Start client handler thread
-        client->clientThread = std::thread(&BluetoothServer::handleClient, this, client);
+        struct epoll_event event = {};
+        event.events = EPOLLIN | EPOLLRDHUP;
+        event.data.fd = clientSocket;
+        if (epoll_ctl(epollFd_, EPOLL_CTL_ADD, clientSocket, &event) < 0) {
+            LOG_ERROR << "Failed to watch client socket: " << strerror(errno);
+            closeClient(client);
+            continue;
+        }
 
         // Notify connection
         if (onClientConnected_) {
@@ -166,73 +361,315 @@ void BluetoothServer::serverLoop() {
     }
 }
 
-void BluetoothServer::handleClient(std::shared_ptr<BluetoothClient> client) {
-    std::string buffer;
-    char readBuffer[1024];
-    
-    while (client->connected && running_) {
-        int bytesRead = read(client->socket, readBuffer, sizeof(readBuffer) - 1);
-        if (bytesRead <= 0) {
-            if (bytesRead < 0) {
-                std::cerr << "Error reading from client " << client->address << ": " << strerror(errno) << std::endl;
+bool BluetoothServer::readFromClient(const std::shared_ptr<BluetoothClient>& client) {
+    FrameParser& frames = client->frames;
+    std::string_view message;
+
+    while (client->connected) {
+        // Read straight into the frame buffer; complete frames are parsed in place
+        ssize_t bytesRead = read(client->socket, frames.prepare(kReadChunkBytes), kReadChunkBytes);
+        if (bytesRead == 0) {
+            return false;
+        }
+        if (bytesRead < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                break;
             }
-            break;
+            if (errno == EINTR) {
+                continue;
+            }
+            LOG_ERROR << "Error reading from client " << client->address << ": " << strerror(errno);
+            return false;
         }
-        
-        readBuffer[bytesRead] = '\0';
-        buffer += readBuffer;
-        
-        // Process complete JSON messages (terminated by newline)
-        size_t pos;
-        while ((pos = buffer.find('\n')) != std::string::npos) {
-            std::string message = buffer.substr(0, pos);
-            buffer = buffer.substr(pos + 1);
-            
-            if (!message.empty()) {
-                try {
-                    nlohmann::json response = handleCommand(message, client->address);
-                    sendResponse(client->socket, response);
-                    
-                    if (onCommandReceived_) {
-                        onCommandReceived_(client->address, message);
-                    }
-                } catch (const std::exception& e) {
-                    nlohmann::json errorResponse = createErrorResponse(
-                        "Invalid command", e.what());
-                    sendResponse(client->socket, errorResponse);
-                }
+        frames.commit(bytesRead);
+
+        // Handle each chunk before reading the next, so a client flooding one
+        // unterminated message is cut off at the limit, not after the socket
+        // has been drained into the buffer
+        while (client->connected && frames.next(message)) {
+            processMessage(client, message);
+        }
+        if (frames.hasError()) {
+            LOG_WARN << "Dropping client " << client->address << ": " << frames.getError();
+            return false;
+        }
+    }
+    return true;
+}
+
+void BluetoothServer::processMessage(const std::shared_ptr<BluetoothClient>& client, std::string_view message) {
+    auto received = std::chrono::steady_clock::now();
+    // Only this thread changes the encoding, so it can be read without writeMutex
+    WireEncoding encoding = client->encoding;
+
+    nlohmann::json request;
+    try {
+        request = decodeMessage(message, encoding);
+    } catch (const nlohmann::json::exception& e) {
+        sendResponse(client, createErrorResponse("Message parsing error", e.what()));
+        return;
+    }
+
+    if (onCommandReceived_) {
+        onCommandReceived_(client->address, encoding == WireEncoding::Json ? std::string(message) : request.dump());
+    }
+
+    std::string action;
+    if (request.is_object() && request.contains("action") && request["action"].is_string()) {
+        action = request["action"];
+    }
+
+    if (isSlowCommand(action)) {
+        runSlowCommand(client, std::move(request), received);
+        return;
+    }
+
+    // Subscriptions are per connection, so they're handled here rather than in handleCommand
+    nlohmann::json response;
+    if (action == "subscribe") {
+        response = handleSubscribe(*client, request);
+    } else if (action == "unsubscribe") {
+        response = handleUnsubscribe(*client);
+    } else if (action == "set_encoding") {
+        handleSetEncoding(client, request);
+        recordCommandLatency(action, received);
+        return;
+    } else {
+        response = handleCommand(request);
+    }
+    if (request.is_object() && request.contains("id")) {
+        response["id"] = request["id"];
+    }
+    sendResponse(client, response);
+    recordCommandLatency(action, received);
+}
+
+void BluetoothServer::runSlowCommand(const std::shared_ptr<BluetoothClient>& client, nlohmann::json request,
+                                     std::chrono::steady_clock::time_point received) {
+    std::string action = request["action"];
+    nlohmann::json id = request.contains("id") ? request["id"] : nlohmann::json();
+
+    // A newer play (or pause/stop) in the same zone cancels any play still in flight
+    Zone* zone = nullptr;
+    uint64_t generation = 0;
+    if (action == "play_podcast") {
+        std::string error;
+        zone = findZone(request, error);
+        if (!zone) {
+            nlohmann::json response = createErrorResponse(error);
+            if (!id.is_null()) {
+                response["id"] = id;
             }
+            sendResponse(client, response);
+            recordCommandLatency(action, received);
+            return;
         }
+        generation = ++zone->playGeneration;
+    }
+
+    // Acknowledge now; the result follows as a command_completed event
+    nlohmann::json ack;
+    ack["status"] = "accepted";
+    ack["action"] = action;
+    nlohmann::json ackResponse = createSuccessResponse(ack);
+    if (!id.is_null()) {
+        ackResponse["id"] = id;
+    }
+    sendResponse(client, ackResponse);
+
+    if (!commandPool_) {
+        commandPool_ = std::make_unique<ThreadPool>(2);
+    }
+    commandPool_->submit([this, client, request = std::move(request), action, id, zone, generation, received] {
+        nlohmann::json result = zone
+            ? handlePlayPodcast(request, *zone, generation)
+            : handleCommand(request);
+
+        nlohmann::json completion;
+        completion["event"] = "command_completed";
+        completion["action"] = action;
+        if (!id.is_null()) {
+            completion["id"] = id;
+        }
+        completion["result"] = result;
+        sendResponse(client, completion);
+        recordCommandLatency(action, received);
+        if (action != "play_podcast") {
+            notifyStatusChanged(); // An import can change the current podcast
+        }
+    });
+}
+
+void BluetoothServer::closeClient(const std::shared_ptr<BluetoothClient>& client) {
+    int socket;
+    {
+        // Writers check the socket under writeMutex, so the fd can't be reused under them
+        std::lock_guard<std::mutex> lock(client->writeMutex);
+        if (client->socket == -1) {
+            return; // Already closed
+        }
+        socket = client->socket;
+        client->connected = false;
+        client->socket = -1;
+        epoll_ctl(epollFd_, EPOLL_CTL_DEL, socket, nullptr);
+        close(socket);
+    }
+    {
+        std::lock_guard<std::mutex> lock(clientsMutex_);
+        connectedClients_.erase(socket);
     }
-    
-    // Client disconnected
-    client->connected = false;
-    close(client->socket);
     
     if (onClientDisconnected_) {
         onClientDisconnected_(client->address);
     }
     
-    std::cout << "Client disconnected: " << client->address << std::endl;
+    LOG_INFO << "Client disconnected: " << client->address;
 }
 
-void BluetoothServer::cleanupDisconnectedClients() {
-    while (running_) {
-        std::this_thread::sleep_for(std::chrono::seconds(5));
-        
+void BluetoothServer::closeAllClients() {
+    std::vector<std::shared_ptr<BluetoothClient>> clients;
+    {
         std::lock_guard<std::mutex> lock(clientsMutex_);
-        auto it = connectedClients_.begin();
-        while (it != connectedClients_.end()) {
-            if (!(*it)->connected) {
-                if ((*it)->clientThread.joinable()) {
-                    (*it)->clientThread.join();
-                }
-                it = connectedClients_.erase(it);
-            } else {
-                ++it;
+        for (const auto& [socket, client] : connectedClients_) {
+            clients.push_back(client);
+        }
+    }
+    for (const auto& client : clients) {
+        closeClient(client);
+    }
+}
+
+void BluetoothServer::notifyStatusChanged() {
+    // Only the first change since the last push wakes the loop; the rest coalesce
+    if (!statusDirty_.exchange(true) && wakeupFd_ != -1) {
+        uint64_t one = 1;
+        if (write(wakeupFd_, &one, sizeof(one)) < 0 && errno != EAGAIN) {
+            LOG_ERROR << "Failed to wake Bluetooth event loop: " << strerror(errno);
+        }
+    }
+}
+
+int BluetoothServer::pushStatusUpdates() {
+    bool dirty = statusDirty_.exchange(false);
+    if (!dirty && !pushPending_) {
+        return -1;
+    }
+    pushPending_ = false;
+
+    std::vector<std::shared_ptr<BluetoothClient>> subscribers;
+    {
+        std::lock_guard<std::mutex> lock(clientsMutex_);
+        for (const auto& [socket, client] : connectedClients_) {
+            if (client->subscribed) {
+                subscribers.push_back(client);
             }
         }
     }
+    if (subscribers.empty()) {
+        return -1;
+    }
+
+    // Built once per zone that has subscribers
+    std::unordered_map<std::string, nlohmann::json> statuses;
+    auto now = std::chrono::steady_clock::now();
+    int timeout = -1;
+
+    for (const auto& client : subscribers) {
+        auto built = statuses.find(client->zone);
+        if (built == statuses.end()) {
+            Zone* zone = findZone(client->zone);
+            built = statuses.emplace(client->zone, zone ? buildStatus(*zone) : nlohmann::json()).first;
+        }
+        const nlohmann::json& status = built->second;
+        if (status.is_null() || status == client->lastStatus) {
+            continue;
+        }
+
+        auto elapsed = now - client->lastPush;
+        if (elapsed < client->pushInterval) {
+            // Too soon for this client; come back when its interval is up
+            auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(client->pushInterval - elapsed);
+            int waitMs = static_cast<int>(wait.count()) + 1;
+            timeout = timeout == -1 ? waitMs : std::min(timeout, waitMs);
+            pushPending_ = true;
+            continue;
+        }
+
+        nlohmann::json changes = nlohmann::json::object();
+        for (const auto& [key, value] : status.items()) {
+            if (!client->lastStatus.contains(key) || client->lastStatus[key] != value) {
+                changes[key] = value;
+            }
+        }
+
+        nlohmann::json event;
+        event["event"] = "status";
+        event["data"] = changes;
+        if (sendResponse(client, event, Delivery::Droppable)) {
+            client->lastStatus = status;
+        } else {
+            // Backed up: try again next interval with a fresh diff
+            int waitMs = static_cast<int>(client->pushInterval.count());
+            timeout = timeout == -1 ? waitMs : std::min(timeout, waitMs);
+            pushPending_ = true;
+        }
+        client->lastPush = now;
+    }
+
+    return timeout;
+}
+
+nlohmann::json BluetoothServer::buildStatus(Zone& zone) {
+    PlaybackStatus playback = zone.player.getStatus();
+
+    nlohmann::json status;
+    status["zone"] = zone.name;
+    status["state"] = playback.state;
+    status["position_ms"] = playback.positionMs;
+    status["length_ms"] = playback.lengthMs;
+    status["buffering"] = static_cast<int>(playback.buffering); // Whole percent keeps diffs quiet
+
+    auto podcast = feedManager_.getCurrentPodcast();
+    if (podcast) {
+        status["podcast"] = podcast->name;
+    } else {
+        status["podcast"] = nullptr;
+    }
+    status["current_index"] = feedManager_.getCurrentIndex();
+
+    {
+        std::lock_guard<std::mutex> lock(nowPlayingMutex_);
+        status["episode"] = zone.nowPlaying;
+    }
+    return status;
+}
+
+BluetoothServer::Zone* BluetoothServer::findZone(const std::string& name) {
+    if (name.empty()) {
+        return zones_.front().get();
+    }
+    for (const auto& zone : zones_) {
+        if (zone->name == name) {
+            return zone.get();
+        }
+    }
+    return nullptr;
+}
+
+BluetoothServer::Zone* BluetoothServer::findZone(const nlohmann::json& request, std::string& error) {
+    if (!request.contains("zone")) {
+        return zones_.front().get();
+    }
+    if (!request["zone"].is_string()) {
+        error = "'zone' must be a string";
+        return nullptr;
+    }
+    std::string name = request["zone"];
+    Zone* zone = name.empty() ? nullptr : findZone(name);
+    if (!zone) {
+        error = "Unknown zone: " + name;
+    }
+    return zone;
 }
 
 bool BluetoothServer::registerService() {
@@ -241,7 +678,7 @@ bool BluetoothServer::registerService() {
     bdaddr_t local_addr = {{0, 0, 0, 0, 0, 0}}; // BDADDR_LOCAL equivalent  
     sdpSession_ = sdp_connect(&any_addr, &local_addr, SDP_RETRY_IF_BUSY);
     if (!sdpSession_) {
-        std::cerr << "Failed to create SDP session" << std::endl;
+        LOG_ERROR << "Failed to create SDP session";
         return false;
     }
 
@@ -281,7 +718,7 @@ bool BluetoothServer::registerService() {
 
     // Register service
     if (sdp_record_register(sdpSession_, record, 0) < 0) {
-        std::cerr << "Failed to register service record" << std::endl;
+        LOG_ERROR << "Failed to register service record";
         sdp_record_free(record);
         sdp_close(sdpSession_);
         return false;
@@ -306,11 +743,14 @@ void BluetoothServer::unregisterService() {
     }
 }
 
-nlohmann::json BluetoothServer::handleCommand(const std::string& command, const std::string& clientAddress) {
+bool BluetoothServer::isSlowCommand(const std::string& action) {
+    // Anything that may touch the network or block on playback start
+    return action == "play_podcast" || action == "add_podcast" || action == "add_podcasts";
+}
+
+nlohmann::json BluetoothServer::handleCommand(const nlohmann::json& request) {
     try {
-        nlohmann::json request = nlohmann::json::parse(command);
-        
-        if (!request.contains("action")) {
+        if (!request.is_object() || !request.contains("action")) {
             return createErrorResponse("Missing 'action' field");
         }
         
@@ -318,24 +758,35 @@ nlohmann::json BluetoothServer::handleCommand(const std::string& command, const
         
         if (action == "add_podcast") {
             return handleAddPodcast(request);
+        } else if (action == "add_podcasts") {
+            return handleAddPodcasts(request);
         } else if (action == "remove_podcast") {
             return handleRemovePodcast(request);
         } else if (action == "list_podcasts") {
             return handleListPodcasts(request);
         } else if (action == "play_podcast") {
-            return handlePlayPodcast(request);
+            std::string error;
+            Zone* zone = findZone(request, error);
+            if (!zone) {
+                return createErrorResponse(error);
+            }
+            return handlePlayPodcast(request, *zone, ++zone->playGeneration);
         } else if (action == "player_control") {
             return handlePlayerControl(request);
         } else if (action == "get_status") {
             return handleGetStatus(request);
         } else if (action == "navigate_podcasts") {
             return handleNavigatePodcasts(request);
+        } else if (action == "get_metrics") {
+            return handleGetMetrics(request);
+        } else if (action == "search") {
+            return handleSearch(request);
         } else {
             return createErrorResponse("Unknown action: " + action);
         }
         
     } catch (const nlohmann::json::exception& e) {
-        return createErrorResponse("JSON parsing error", e.what());
+        return createErrorResponse("Invalid request", e.what());
     }
 }
 
@@ -361,6 +812,30 @@ nlohmann::json BluetoothServer::handleAddPodcast(const nlohmann::json& request)
     }
 }
 
+nlohmann::json BluetoothServer::handleAddPodcasts(const nlohmann::json& request) {
+    if (!request.contains("podcasts") || !request["podcasts"].is_array()) {
+        return createErrorResponse("Missing 'podcasts' array");
+    }
+
+    std::vector<Subscription> podcasts;
+    podcasts.reserve(request["podcasts"].size());
+    for (const auto& entry : request["podcasts"]) {
+        if (!entry.is_object() || !entry.contains("name") || !entry.contains("url")) {
+            return createErrorResponse("Each podcast needs 'name' and 'url' fields");
+        }
+        podcasts.emplace_back(entry["name"].get<std::string>(), entry["url"].get<std::string>(),
+                              entry.value("description", ""));
+    }
+
+    size_t added = feedManager_.addPodcasts(podcasts);
+
+    nlohmann::json data;
+    data["message"] = "Imported podcasts";
+    data["added"] = added;
+    data["skipped"] = podcasts.size() - added;
+    return createSuccessResponse(data);
+}
+
 nlohmann::json BluetoothServer::handleRemovePodcast(const nlohmann::json& request) {
     if (!request.contains("identifier")) {
         return createErrorResponse("Missing 'identifier' field");
@@ -370,6 +845,7 @@ nlohmann::json BluetoothServer::handleRemovePodcast(const nlohmann::json& reques
     bool success = feedManager_.removePodcast(identifier);
     
     if (success) {
+        notifyStatusChanged(); // The current podcast may have moved
         nlohmann::json data;
         data["message"] = "Podcast removed successfully";
         data["identifier"] = identifier;
@@ -380,40 +856,74 @@ nlohmann::json BluetoothServer::handleRemovePodcast(const nlohmann::json& reques
 }
 
 nlohmann::json BluetoothServer::handleListPodcasts(const nlohmann::json& request) {
-    auto subscriptions = feedManager_.getSubscriptions();
-    auto currentPodcast = feedManager_.getCurrentPodcast();
+    // Reads the published snapshot in place; nothing is copied or locked
+    auto subscriptions = feedManager_.getSnapshot();
+    int currentIndex = feedManager_.getCurrentIndex();
+
+    // Optional paging and field selection keep responses small over RFCOMM
+    size_t total = subscriptions->size();
+    size_t offset = std::min<size_t>(request.value("offset", size_t{0}), total);
+    size_t limit = request.value("limit", total);
+    size_t end = offset + std::min(limit, total - offset);
+
+    bool wanted[std::size(kListFields)];
+    if (request.contains("fields")) {
+        if (!request["fields"].is_array()) {
+            return createErrorResponse("'fields' must be an array");
+        }
+        std::fill(std::begin(wanted), std::end(wanted), false);
+        for (const auto& field : request["fields"]) {
+            auto it = std::find_if(std::begin(kListFields), std::end(kListFields),
+                                   [&field](const char* name) { return field == name; });
+            if (it == std::end(kListFields)) {
+                return createErrorResponse("Unknown field: " + field.dump());
+            }
+            wanted[it - std::begin(kListFields)] = true;
+        }
+    } else {
+        std::fill(std::begin(wanted), std::end(wanted), true);
+    }
     
     nlohmann::json data;
     data["podcasts"] = nlohmann::json::array();
-    data["current_index"] = feedManager_.getCurrentIndex();
+    data["current_index"] = currentIndex;
+    data["total"] = total;
+    data["offset"] = offset;
+    if (end < total) {
+        data["next_offset"] = end;
+    }
     
-    for (size_t i = 0; i < subscriptions.size(); ++i) {
-        const auto& sub = subscriptions[i];
-        nlohmann::json podcast;
-        podcast["index"] = i;
-        podcast["name"] = sub.name;
-        podcast["url"] = sub.feedUrl;
-        podcast["description"] = sub.description;
-        podcast["enabled"] = sub.enabled;
-        podcast["is_current"] = (currentPodcast && currentPodcast->id == sub.id);
+    for (size_t i = offset; i < end; ++i) {
+        const auto& sub = (*subscriptions)[i];
+        nlohmann::json podcast = nlohmann::json::object();
+        if (wanted[0]) podcast["index"] = i;
+        if (wanted[1]) podcast["name"] = sub.name;
+        if (wanted[2]) podcast["url"] = sub.feedUrl;
+        if (wanted[3]) podcast["description"] = sub.description;
+        if (wanted[4]) podcast["enabled"] = sub.enabled;
+        if (wanted[5]) podcast["is_current"] = static_cast<int>(i) == currentIndex;
         
-        data["podcasts"].push_back(podcast);
+        data["podcasts"].push_back(std::move(podcast));
     }
     
     return createSuccessResponse(data);
 }
 
-nlohmann::json BluetoothServer::handlePlayPodcast(const nlohmann::json& request) {
+nlohmann::json BluetoothServer::handlePlayPodcast(const nlohmann::json& request, Zone& zone, uint64_t generation) {
+    auto cancelled = [&zone, generation] { return generation != zone.playGeneration; };
+
     try {
+        if (cancelled()) {
+            return createErrorResponse("Cancelled", "Superseded by a newer command");
+        }
+
+        nlohmann::json data;
+        Episode target;
+
         if (request.contains("url")) {
             // Play from direct URL
-            std::string url = request["url"];
-            player_.play(url);
-            
-            nlohmann::json data;
-            data["message"] = "Playing from URL";
-            data["url"] = url;
-            return createSuccessResponse(data);
+            target.url = request["url"];
+            data["message"] = "Starting playback from URL";
         } else {
             // Play current podcast's latest episode
             auto podcast = feedManager_.getCurrentPodcast();
@@ -426,15 +936,47 @@ nlohmann::json BluetoothServer::handlePlayPodcast(const nlohmann::json& request)
                 return createErrorResponse("Could not load episodes");
             }
             
-            player_.play(episode->url);
-            
-            nlohmann::json data;
-            data["message"] = "Playing podcast episode";
+            target = *episode;
+            data["message"] = "Starting podcast episode";
             data["podcast"] = podcast->name;
             data["episode"] = episode->title;
-            data["url"] = episode->url;
-            return createSuccessResponse(data);
         }
+        data["url"] = target.url;
+        data["zone"] = zone.name;
+        data["status"] = "starting";
+
+        // The feed fetch can't be interrupted, but its result can be dropped
+        if (cancelled()) {
+            return createErrorResponse("Cancelled", "Superseded by a newer command");
+        }
+
+        // Reply now; clients learn the outcome from a pushed playback event
+        nlohmann::json eventData = data;
+        // Episodes resume where they were left off; plain URLs start at the beginning
+        Zone* playing = &zone;
+        zone.player.playAsync(target, [this, playing, eventData](bool success, const std::string& error) mutable {
+            nlohmann::json event;
+            event["event"] = success ? "playback_started" : "playback_failed";
+            eventData.erase("message");
+            eventData["status"] = success ? "playing" : "failed";
+            if (!success) {
+                eventData["error"] = error;
+            }
+            event["data"] = eventData;
+            broadcastMessage(event);
+
+            if (success) {
+                nlohmann::json episode;
+                episode["title"] = eventData.value("episode", "");
+                episode["url"] = eventData["url"];
+                std::lock_guard<std::mutex> lock(nowPlayingMutex_);
+                playing->nowPlaying = episode;
+            }
+            notifyStatusChanged();
+        }, cancelled);
+        preloadAdjacentEpisodes(zone.player);
+
+        return createSuccessResponse(data);
     } catch (const std::exception& e) {
         return createErrorResponse("Playback failed", e.what());
     }
@@ -446,15 +988,22 @@ nlohmann::json BluetoothServer::handlePlayerControl(const nlohmann::json& reques
     }
     
     std::string command = request["command"];
+    std::string error;
+    Zone* zone = findZone(request, error);
+    if (!zone) {
+        return createErrorResponse(error);
+    }
     
     try {
         if (command == "pause") {
-            player_.pause();
+            ++zone->playGeneration; // Don't let a pending play resume behind the user's back
+            zone->player.pause();
             nlohmann::json data;
             data["message"] = "Playback paused";
             return createSuccessResponse(data);
         } else if (command == "stop") {
-            player_.stop();
+            ++zone->playGeneration;
+            zone->player.stop();
             nlohmann::json data;
             data["message"] = "Playback stopped";
             return createSuccessResponse(data);
@@ -466,11 +1015,97 @@ nlohmann::json BluetoothServer::handlePlayerControl(const nlohmann::json& reques
     }
 }
 
+nlohmann::json BluetoothServer::handleGetMetrics(const nlohmann::json& /*request*/) {
+    return createSuccessResponse(MetricsRegistry::global().toJson());
+}
+
+nlohmann::json BluetoothServer::handleSearch(const nlohmann::json& request) {
+    if (!request.contains("query") || !request["query"].is_string()) {
+        return createErrorResponse("Missing 'query' field");
+    }
+
+    SearchQuery query;
+    query.text = request["query"];
+    query.offset = request.value("offset", size_t{0});
+    query.limit = std::min(request.value("limit", kDefaultSearchLimit), kMaxSearchLimit);
+
+    std::string scope = request.value("scope", "all");
+    if (scope == "podcasts") {
+        query.scope = SearchScope::Podcasts;
+    } else if (scope == "episodes") {
+        query.scope = SearchScope::Episodes;
+    } else if (scope != "all") {
+        return createErrorResponse("Unknown scope: " + scope, "Supported: all, podcasts, episodes");
+    }
+
+    auto subscriptions = feedManager_.getSnapshot();
+    if (request.contains("podcast")) {
+        int index = subscriptions->find(request["podcast"].get<std::string>());
+        if (index == -1) {
+            return createErrorResponse("Podcast not found");
+        }
+        query.subscriptionId = (*subscriptions)[index].id;
+    }
+
+    SearchResults results = feedManager_.search(query);
+
+    nlohmann::json data;
+    data["results"] = nlohmann::json::array();
+    data["total"] = results.total;
+    data["offset"] = query.offset;
+    if (query.offset + results.hits.size() < results.total) {
+        data["next_offset"] = query.offset + results.hits.size();
+    }
+
+    for (const auto& hit : results.hits) {
+        int index = subscriptions->find(hit.subscriptionId);
+        if (index == -1) {
+            continue; // Removed since the snapshot was taken
+        }
+
+        nlohmann::json result;
+        if (hit.isEpisode()) {
+            EpisodeView episode = hit.entry->episodes[hit.episodeIndex];
+            result["type"] = "episode";
+            result["podcast"] = (*subscriptions)[index].name;
+            result["podcast_index"] = index;
+            result["title"] = episode.title;
+            result["url"] = episode.url;
+            result["pub_date"] = episode.pubDate;
+            result["duration"] = episode.duration;
+        } else {
+            result["type"] = "podcast";
+            result["name"] = (*subscriptions)[index].name;
+            result["index"] = index;
+        }
+        data["results"].push_back(std::move(result));
+    }
+
+    return createSuccessResponse(data);
+}
+
 nlohmann::json BluetoothServer::handleGetStatus(const nlohmann::json& request) {
+    std::string error;
+    Zone* zone = findZone(request, error);
+    if (!zone) {
+        return createErrorResponse(error);
+    }
+
     nlohmann::json data;
     
-    // Player status
-    data["player"]["playing"] = player_.isPlaying();
+    // Player status of the addressed zone, and a summary of every zone
+    data["zone"] = zone->name;
+    // The status snapshot, not isPlaying(): that takes the control lock,
+    // which a starting play holds across blocking libvlc calls
+    data["player"]["playing"] = zone->player.getStatus().state == "playing";
+    data["zones"] = nlohmann::json::array();
+    for (const auto& other : zones_) {
+        nlohmann::json summary;
+        summary["name"] = other->name;
+        summary["state"] = other->player.getStatus().state;
+        summary["audio_device"] = other->player.getAudioDevice();
+        data["zones"].push_back(std::move(summary));
+    }
     
     // Current podcast
     auto currentPodcast = feedManager_.getCurrentPodcast();
@@ -498,6 +1133,11 @@ nlohmann::json BluetoothServer::handleNavigatePodcasts(const nlohmann::json& req
     }
     
     std::string direction = request["direction"];
+    std::string error;
+    Zone* zone = findZone(request, error);
+    if (!zone) {
+        return createErrorResponse(error);
+    }
     
     try {
         std::optional<Subscription> podcast;
@@ -517,6 +1157,13 @@ nlohmann::json BluetoothServer::handleNavigatePodcasts(const nlohmann::json& req
             data["podcast"]["url"] = podcast->feedUrl;
             data["podcast"]["description"] = podcast->description;
             data["index"] = feedManager_.getCurrentIndex();
+            notifyStatusChanged();
+            // Preloading reads cached feeds and drives libvlc; keep it off the event loop
+            if (commandPool_) {
+                commandPool_->submit([this, player = &zone->player] { preloadAdjacentEpisodes(*player); });
+            } else {
+                preloadAdjacentEpisodes(zone->player);
+            }
             return createSuccessResponse(data);
         } else {
             return createErrorResponse("No podcasts available");
@@ -526,22 +1173,186 @@ nlohmann::json BluetoothServer::handleNavigatePodcasts(const nlohmann::json& req
     }
 }
 
-void BluetoothServer::sendResponse(int clientSocket, const nlohmann::json& response) {
-    std::string responseStr = response.dump() + "\n";
-    
-    ssize_t bytesSent = write(clientSocket, responseStr.c_str(), responseStr.length());
-    if (bytesSent == -1) {
-        std::cerr << "Failed to send response: " << strerror(errno) << std::endl;
+nlohmann::json BluetoothServer::handleSubscribe(BluetoothClient& client, const nlohmann::json& request) {
+    int intervalMs = kDefaultPushIntervalMs;
+    if (request.contains("interval_ms")) {
+        if (!request["interval_ms"].is_number_integer()) {
+            return createErrorResponse("'interval_ms' must be an integer");
+        }
+        intervalMs = std::max(request["interval_ms"].get<int>(), kMinPushIntervalMs);
+    }
+    std::string error;
+    Zone* zone = findZone(request, error);
+    if (!zone) {
+        return createErrorResponse(error);
+    }
+
+    // The reply carries the full status; later events only carry what changed
+    client.subscribed = true;
+    client.zone = zone->name;
+    client.pushInterval = std::chrono::milliseconds(intervalMs);
+    client.lastStatus = buildStatus(*zone);
+    client.lastPush = std::chrono::steady_clock::now();
+
+    nlohmann::json data;
+    data["subscribed"] = true;
+    data["interval_ms"] = intervalMs;
+    data["status"] = client.lastStatus;
+    return createSuccessResponse(data);
+}
+
+nlohmann::json BluetoothServer::handleUnsubscribe(BluetoothClient& client) {
+    client.subscribed = false;
+    client.lastStatus = nullptr;
+
+    nlohmann::json data;
+    data["subscribed"] = false;
+    return createSuccessResponse(data);
+}
+
+void BluetoothServer::handleSetEncoding(const std::shared_ptr<BluetoothClient>& client, const nlohmann::json& request) {
+    std::string name = request.value("encoding", "");
+    WireEncoding encoding;
+    nlohmann::json response;
+    if (!parseEncoding(name, encoding)) {
+        response = createErrorResponse("Unknown encoding: " + name, "Supported: json, cbor, msgpack");
+    } else {
+        nlohmann::json data;
+        data["encoding"] = name;
+        data["framing"] = encoding == WireEncoding::Json ? "newline" : "length_prefixed";
+        response = createSuccessResponse(data);
+    }
+    if (request.contains("id")) {
+        response["id"] = request["id"];
+    }
+    sendResponse(client, response);
+    if (response["success"] == false) {
+        return;
+    }
+
+    // Everything after the reply, in both directions, uses the new encoding
+    {
+        std::lock_guard<std::mutex> lock(client->writeMutex);
+        client->encoding = encoding;
+    }
+    client->frames.setFraming(encoding == WireEncoding::Json
+        ? FrameParser::Framing::Line
+        : FrameParser::Framing::LengthPrefixed);
+}
+
+bool BluetoothServer::sendResponse(const std::shared_ptr<BluetoothClient>& client, const nlohmann::json& response,
+                                   Delivery delivery) {
+    std::lock_guard<std::mutex> lock(client->writeMutex);
+    if (client->socket == -1 || !client->connected) {
+        return false;
+    }
+    if (delivery == Delivery::Droppable && client->queuedBytes > kDroppableQueueBytes) {
+        return false;
+    }
+
+    std::string frame;
+    encodeMessage(response, client->encoding, frame);
+    if (client->queuedBytes + frame.size() > kMaxQueuedBytes) {
+        // Never let one stalled reader pin unbounded memory; the event loop
+        // sees the hang-up and closes the connection
+        LOG_WARN << "Disconnecting slow client " << client->address << ": "
+                 << client->queuedBytes << " bytes unsent";
+        client->connected = false;
+        client->writeQueue.clear();
+        client->writeOffset = 0;
+        client->queuedBytes = 0;
+        shutdown(client->socket, SHUT_RDWR);
+        return false;
+    }
+
+    client->queuedBytes += frame.size();
+    client->writeQueue.push_back(std::move(frame));
+
+    // While waiting for EPOLLOUT, frames just accumulate and go out in one writev
+    if (!client->wantsWrite) {
+        flushClient(*client);
+    }
+    return true;
+}
+
+void BluetoothServer::flushClient(BluetoothClient& client) {
+    while (!client.writeQueue.empty() && client.socket != -1) {
+        struct iovec iov[kMaxIovecs];
+        int count = 0;
+        size_t offset = client.writeOffset;
+        for (auto it = client.writeQueue.begin(); it != client.writeQueue.end() && count < kMaxIovecs; ++it) {
+            iov[count].iov_base = const_cast<char*>(it->data()) + offset;
+            iov[count].iov_len = it->size() - offset;
+            offset = 0;
+            ++count;
+        }
+
+        // sendmsg rather than writev so a vanished peer can't raise SIGPIPE
+        struct msghdr message = {};
+        message.msg_iov = iov;
+        message.msg_iovlen = count;
+        ssize_t bytesSent = sendmsg(client.socket, &message, MSG_NOSIGNAL);
+        if (bytesSent > 0) {
+            size_t remaining = static_cast<size_t>(bytesSent);
+            while (remaining > 0) {
+                size_t frameLeft = client.writeQueue.front().size() - client.writeOffset;
+                if (remaining < frameLeft) {
+                    client.writeOffset += remaining; // Partial write; resume mid-frame
+                    break;
+                }
+                remaining -= frameLeft;
+                client.queuedBytes -= client.writeQueue.front().size();
+                client.writeQueue.pop_front();
+                client.writeOffset = 0;
+            }
+        } else if (bytesSent < 0 && errno == EINTR) {
+            continue;
+        } else if (bytesSent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            break; // Resume on EPOLLOUT
+        } else {
+            // The event loop closes the client on the accompanying error event
+            LOG_ERROR << "Failed to send response to " << client.address << ": " << strerror(errno);
+            client.connected = false;
+            client.writeQueue.clear();
+            client.writeOffset = 0;
+            client.queuedBytes = 0;
+            break;
+        }
+    }
+    updateInterest(client, !client.writeQueue.empty());
+}
+
+void BluetoothServer::updateInterest(BluetoothClient& client, bool wantsWrite) {
+    if (client.wantsWrite == wantsWrite || client.socket == -1) {
+        return;
+    }
+    struct epoll_event event = {};
+    event.events = EPOLLIN | EPOLLRDHUP | (wantsWrite ? static_cast<uint32_t>(EPOLLOUT) : 0u);
+    event.data.fd = client.socket;
+    if (epoll_ctl(epollFd_, EPOLL_CTL_MOD, client.socket, &event) == 0) {
+        client.wantsWrite = wantsWrite;
     }
 }
 
 void BluetoothServer::broadcastMessage(const nlohmann::json& message) {
-    std::lock_guard<std::mutex> lock(clientsMutex_);
-    for (const auto& client : connectedClients_) {
-        if (client->connected) {
-            sendResponse(client->socket, message);
+    std::vector<std::shared_ptr<BluetoothClient>> clients;
+    {
+        std::lock_guard<std::mutex> lock(clientsMutex_);
+        for (const auto& [socket, client] : connectedClients_) {
+            clients.push_back(client);
         }
     }
+    for (const auto& client : clients) {
+        sendResponse(client, message);
+    }
+}
+
+void BluetoothServer::preloadAdjacentEpisodes(Player& player) {
+    std::vector<std::string> urls;
+    for (const auto& episode : feedManager_.getAdjacentEpisodes()) {
+        urls.push_back(episode.url);
+    }
+    player.preload(urls);
 }
 
 nlohmann::json BluetoothServer::createErrorResponse(const std::string& error, const std::string& details) {
@@ -0,0 +1,183 @@
+#include "core/DebouncedWriter.hpp"
+#include "core/Logger.hpp"
+#include <filesystem>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace podradio {
+namespace core {
+
+namespace {
+
+bool writeAll(int fd, const std::string& content) {
+    const char* data = content.data();
+    size_t remaining = content.size();
+    while (remaining > 0) {
+        ssize_t written = ::write(fd, data, remaining);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        data += written;
+        remaining -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+// Makes a completed rename durable; the new directory entry lives in the parent
+void syncDirectory(const std::string& path) {
+    std::string directory = std::filesystem::path(path).parent_path().string();
+    int fd = ::open(directory.empty() ? "." : directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd < 0) {
+        LOG_WARN << "Could not open directory to sync " << path << ": " << strerror(errno);
+        return;
+    }
+    if (::fsync(fd) != 0) {
+        LOG_WARN << "Could not sync directory of " << path << ": " << strerror(errno);
+    }
+    ::close(fd);
+}
+
+} // namespace
+
+bool writeFileAtomically(const std::string& path, const std::string& content) {
+    std::string tempPath = path + ".tmp";
+    int fd = ::open(tempPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        LOG_ERROR << "Could not open file for writing: " << tempPath << ": " << strerror(errno);
+        return false;
+    }
+
+    // The data must be on disk before the rename is, or a power cut can
+    // leave the new name pointing at an empty file
+    bool ok = writeAll(fd, content) && ::fsync(fd) == 0;
+    int error = errno;
+    if (::close(fd) != 0 && ok) {
+        ok = false;
+        error = errno;
+    }
+    if (!ok) {
+        LOG_ERROR << "Failed writing " << tempPath << ": " << strerror(error);
+        ::unlink(tempPath.c_str());
+        return false;
+    }
+
+    if (::rename(tempPath.c_str(), path.c_str()) != 0) {
+        LOG_ERROR << "Error replacing " << path << ": " << strerror(errno);
+        ::unlink(tempPath.c_str());
+        return false;
+    }
+    syncDirectory(path);
+    return true;
+}
+
+DebouncedWriter::DebouncedWriter(std::string path, Serializer serialize,
+                                 std::chrono::milliseconds delay, std::chrono::milliseconds maxDelay)
+    : path_(std::move(path)), serialize_(std::move(serialize)), delay_(delay), maxDelay_(maxDelay),
+      dirty_(false), stopping_(false) {
+    thread_ = std::thread(&DebouncedWriter::writerLoop, this);
+}
+
+DebouncedWriter::~DebouncedWriter() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    cv_.notify_all();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    flush();
+}
+
+void DebouncedWriter::markDirty() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto now = std::chrono::steady_clock::now();
+        if (!dirty_) {
+            dirty_ = true;
+            firstChange_ = now;
+        }
+        lastChange_ = now;
+    }
+    cv_.notify_all();
+}
+
+void DebouncedWriter::flush() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!dirty_) {
+            return;
+        }
+        dirty_ = false;
+    }
+    if (!write()) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        retryLocked();
+    }
+}
+
+bool DebouncedWriter::isDirty() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return dirty_;
+}
+
+void DebouncedWriter::writerLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        cv_.wait(lock, [this] { return dirty_ || stopping_; });
+        if (stopping_) {
+            return; // The destructor flushes what's left
+        }
+
+        // Wait for the burst to settle
+        while (dirty_ && !stopping_) {
+            auto deadline = std::min(lastChange_ + delay_, firstChange_ + maxDelay_);
+            if (std::chrono::steady_clock::now() >= deadline) {
+                break;
+            }
+            cv_.wait_until(lock, deadline);
+        }
+        if (!dirty_ || stopping_) {
+            continue; // Flushed meanwhile, or shutting down
+        }
+
+        dirty_ = false;
+        lock.unlock();
+        bool written = write();
+        lock.lock();
+        if (!written) {
+            retryLocked();
+        }
+    }
+}
+
+bool DebouncedWriter::write() {
+    std::lock_guard<std::mutex> lock(writeMutex_);
+    try {
+        // Serialized at write time so the newest state is what lands on disk
+        return writeFileAtomically(path_, serialize_());
+    } catch (const std::exception& e) {
+        LOG_ERROR << "Error saving " << path_ << ": " << e.what();
+        return false;
+    }
+}
+
+void DebouncedWriter::retryLocked() {
+    if (dirty_) {
+        return; // A newer change is already waiting for its own write
+    }
+    // Keep the change pending. A full or failing disk is retried every
+    // maxDelay rather than hammered: firstChange_ alone sets the deadline.
+    auto now = std::chrono::steady_clock::now();
+    dirty_ = true;
+    firstChange_ = now;
+    lastChange_ = now + maxDelay_;
+    cv_.notify_all();
+}
+
+} // namespace core
+} // namespace podradio
@@ -0,0 +1,351 @@
+#include "core/DownloadManager.hpp"
+#include "core/Logger.hpp"
+#include "core/HttpClient.hpp"
+#include "core/Metrics.hpp"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+namespace podradio {
+namespace core {
+
+namespace {
+
+int64_t nowMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+// Short alphanumeric extension of the URL path ("mp3", "m4a"), or empty
+std::string extensionOf(const std::string& url) {
+    size_t end = url.find_first_of("?#");
+    std::string path = url.substr(0, end);
+    size_t slash = path.rfind('/');
+    size_t dot = path.rfind('.');
+    if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) {
+        return "";
+    }
+    std::string ext = path.substr(dot + 1);
+    if (ext.empty() || ext.size() > 5 ||
+        !std::all_of(ext.begin(), ext.end(), [](unsigned char c) { return std::isalnum(c); })) {
+        return "";
+    }
+    std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+    return ext;
+}
+
+} // namespace
+
+DownloadManager::DownloadManager(const DownloadOptions& options)
+    : options_(options), storedBytes_(0),
+      indexWriter_((std::filesystem::path(options.directory) / "index.json").string(),
+                   [this] { return serializeIndex(); }) {
+    if (options_.maxConcurrent == 0) {
+        options_.maxConcurrent = 1;
+    }
+
+    std::error_code ec;
+    std::filesystem::create_directories(options_.directory, ec);
+    if (ec) {
+        LOG_WARN << "Cannot create download directory " << options_.directory << ": " << ec.message();
+    }
+    loadIndex();
+}
+
+DownloadManager::~DownloadManager() {
+    stopping_ = true; // Running transfers abort from their write callback
+
+    std::unique_ptr<ThreadPool> pool;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pool = std::move(pool_);
+    }
+    if (pool) {
+        pool->clearPending();
+        pool.reset();
+    }
+}
+
+void DownloadManager::enqueue(const std::string& url) {
+    if (url.empty() || stopping_) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(url);
+    if (it != entries_.end() && it->second.complete) {
+        return;
+    }
+    if (!queued_.insert(url).second) {
+        return;
+    }
+
+    if (!pool_) {
+        pool_ = std::make_unique<ThreadPool>(options_.maxConcurrent);
+    }
+    pool_->submit([this, url] { download(url); });
+}
+
+void DownloadManager::enqueueLatest(const EpisodeStore& episodes) {
+    size_t count = std::min(options_.episodesPerSubscription, episodes.size());
+    for (size_t i = 0; i < count; ++i) {
+        enqueue(std::string(episodes[i].url));
+    }
+}
+
+std::string DownloadManager::localPathFor(const std::string& url) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(url);
+    if (it == entries_.end() || !it->second.complete) {
+        return "";
+    }
+
+    std::string path = pathOf(it->second.file);
+    std::error_code ec;
+    if (!std::filesystem::exists(path, ec)) {
+        // Deleted behind our back; forget it so it can be fetched again
+        storedBytes_ -= it->second.size;
+        entries_.erase(it);
+        indexWriter_.markDirty();
+        return "";
+    }
+
+    it->second.lastUsed = nowMs();
+    indexWriter_.markDirty();
+    return path;
+}
+
+uint64_t DownloadManager::getStoredBytes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return storedBytes_;
+}
+
+size_t DownloadManager::getPendingCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return queued_.size();
+}
+
+void DownloadManager::download(const std::string& url) {
+    std::string file;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        Entry& entry = entries_[url];
+        if (entry.file.empty()) {
+            entry.file = fileNameFor(url);
+        }
+        file = entry.file;
+    }
+
+    std::string finalPath = pathOf(file);
+    std::string partPath = finalPath + ".part";
+    bool ok = transfer(url, partPath);
+
+    uint64_t size = 0;
+    if (ok) {
+        std::error_code ec;
+        std::filesystem::rename(partPath, finalPath, ec);
+        if (!ec) {
+            size = std::filesystem::file_size(finalPath, ec);
+        }
+        ok = !ec;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    queued_.erase(url);
+    // Incomplete entries stay indexed so the next attempt resumes the same file
+    indexWriter_.markDirty();
+    if (!ok) {
+        return;
+    }
+
+    Entry& entry = entries_[url];
+    entry.complete = true;
+    entry.size = size;
+    entry.lastUsed = nowMs();
+    storedBytes_ += size;
+    evictLocked(url);
+    LOG_INFO << "Downloaded " << url << " (" << size / 1024 << " KiB)";
+}
+
+bool DownloadManager::transfer(const std::string& url, const std::string& partPath) {
+    std::error_code ec;
+    uint64_t offset = std::filesystem::exists(partPath, ec) ? std::filesystem::file_size(partPath, ec) : 0;
+    if (ec) {
+        offset = 0;
+    }
+
+    cpr::Header header{{"User-Agent", "Mozilla/5.0 (compatible; PodRadio/1.0)"}};
+    if (offset > 0) {
+        header["Range"] = "bytes=" + std::to_string(offset) + "-";
+    }
+
+    auto session = HttpClient::shared().acquire(url);
+    session->SetUrl(cpr::Url{url});
+    session->SetHeader(header);
+    session->SetConnectTimeout(cpr::ConnectTimeout{15000});
+    session->SetLowSpeed(cpr::LowSpeed{1, 60}); // Give up on a transfer stalled for a minute
+    if (options_.bandwidthBytesPerSecond > 0) {
+        // Each transfer gets an equal share so the total stays within budget
+        session->SetLimitRate(cpr::LimitRate{
+            std::max<int64_t>(1, options_.bandwidthBytesPerSecond / static_cast<int64_t>(options_.maxConcurrent)), 0});
+    }
+
+    static Counter& bytesRead = MetricsRegistry::global().counter("downloads.bytes_read");
+    static Counter& failures = MetricsRegistry::global().counter("downloads.failures");
+
+    std::ofstream out;
+    auto holder = session->GetCurlHolder();
+    auto response = session->Download(cpr::WriteCallback{[&](std::string data, intptr_t) {
+        if (stopping_) {
+            return false;
+        }
+        if (!out.is_open()) {
+            // Headers are complete by the first body chunk
+            long code = 0;
+            curl_easy_getinfo(holder->handle, CURLINFO_RESPONSE_CODE, &code);
+            if (code != 200 && code != 206) {
+                return false;
+            }
+            // A server that ignores Range sends the whole file again
+            bool resume = code == 206 && offset > 0;
+            out.open(partPath, std::ios::binary | std::ios::out | (resume ? std::ios::app : std::ios::trunc));
+            if (!out.is_open()) {
+                return false;
+            }
+        }
+        out.write(data.data(), data.size());
+        bytesRead.add(data.size());
+        return static_cast<bool>(out);
+    }});
+    bool wrote = out.is_open() && static_cast<bool>(out);
+    out.close();
+
+    if (stopping_) {
+        return false;
+    }
+    if (response.status_code == 416 && offset > 0) {
+        // The partial file no longer matches the remote one; start over next time
+        std::filesystem::remove(partPath, ec);
+        return false;
+    }
+    if ((response.status_code == 200 || response.status_code == 206) &&
+        response.error.code == cpr::ErrorCode::OK && wrote) {
+        return true;
+    }
+
+    failures.add();
+    if (response.error.code != cpr::ErrorCode::OK) {
+        LOG_ERROR << "Download failed for " << url << ": HTTP " << response.status_code
+                  << " (" << response.error.message << ")";
+    } else {
+        LOG_ERROR << "Download failed for " << url << ": HTTP " << response.status_code;
+    }
+    return false;
+}
+
+void DownloadManager::evictLocked(const std::string& keepUrl) {
+    while (storedBytes_ > options_.diskQuotaBytes) {
+        auto victim = entries_.end();
+        for (auto it = entries_.begin(); it != entries_.end(); ++it) {
+            if (it->second.complete && it->first != keepUrl &&
+                (victim == entries_.end() || it->second.lastUsed < victim->second.lastUsed)) {
+                victim = it;
+            }
+        }
+        if (victim == entries_.end()) {
+            break;
+        }
+
+        std::error_code ec;
+        std::filesystem::remove(pathOf(victim->second.file), ec);
+        LOG_INFO << "Evicted download " << victim->first;
+        storedBytes_ -= victim->second.size;
+        entries_.erase(victim);
+        indexWriter_.markDirty();
+    }
+}
+
+void DownloadManager::loadIndex() {
+    std::ifstream file(indexWriter_.getPath());
+    if (!file.is_open()) {
+        return;
+    }
+
+    nlohmann::json j;
+    try {
+        file >> j;
+    } catch (const std::exception& e) {
+        LOG_WARN << "Ignoring corrupt download index: " << e.what();
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    bool dropped = false;
+    for (const auto& item : j.value("episodes", nlohmann::json::array())) {
+        Entry entry;
+        std::string url = item.value("url", "");
+        entry.file = item.value("file", "");
+        entry.complete = item.value("complete", false);
+        entry.lastUsed = item.value("lastUsed", int64_t{0});
+        if (url.empty() || entry.file.empty()) {
+            continue;
+        }
+
+        // Trust the file system over the index for what actually exists
+        std::error_code ec;
+        std::string path = pathOf(entry.file) + (entry.complete ? "" : ".part");
+        uint64_t size = std::filesystem::file_size(path, ec);
+        if (ec) {
+            dropped = true;
+            continue;
+        }
+        if (entry.complete) {
+            entry.size = size;
+            storedBytes_ += size;
+        }
+        entries_[url] = entry;
+    }
+
+    evictLocked("");
+    if (dropped) {
+        indexWriter_.markDirty();
+    }
+}
+
+std::string DownloadManager::serializeIndex() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    nlohmann::json j;
+    j["episodes"] = nlohmann::json::array();
+    for (const auto& [url, entry] : entries_) {
+        j["episodes"].push_back({
+            {"url", url},
+            {"file", entry.file},
+            {"size", entry.size},
+            {"complete", entry.complete},
+            {"lastUsed", entry.lastUsed}
+        });
+    }
+    return j.dump();
+}
+
+std::string DownloadManager::pathOf(const std::string& file) const {
+    return (std::filesystem::path(options_.directory) / file).string();
+}
+
+std::string DownloadManager::fileNameFor(const std::string& url) {
+    std::stringstream name;
+    name << std::hex << std::setw(16) << std::setfill('0') << std::hash<std::string>{}(url);
+    std::string ext = extensionOf(url);
+    if (!ext.empty()) {
+        name << '.' << ext;
+    }
+    return name.str();
+}
+
+} // namespace core
+} // namespace podradio
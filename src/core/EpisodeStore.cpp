@@ -0,0 +1,167 @@
+#include "core/EpisodeStore.hpp"
+#include "core/RssStreamParser.hpp"
+#include <algorithm>
+#include <stdexcept>
+#include <functional>
+
+namespace podradio {
+namespace core {
+
+namespace {
+
+const size_t kMinGuidSlots = 16;
+
+uint32_t hashGuid(std::string_view guid) {
+    return static_cast<uint32_t>(std::hash<std::string_view>{}(guid));
+}
+
+} // namespace
+
+std::string EpisodeView::description() const {
+    if (descriptionEncoded) {
+        return RssStreamParser::decodeEntities(rawDescription);
+    }
+    return std::string(rawDescription);
+}
+
+Episode EpisodeView::toEpisode() const {
+    Episode episode;
+    episode.title = std::string(title);
+    episode.description = description();
+    episode.url = std::string(url);
+    episode.pubDate = std::string(pubDate);
+    episode.duration = std::string(duration);
+    episode.guid = std::string(guid);
+    return episode;
+}
+
+void EpisodeStore::clear() {
+    arena_.clear();
+    records_.clear();
+    guidSlots_.clear();
+    guidCount_ = 0;
+}
+
+void EpisodeStore::reserve(size_t episodeCount, size_t arenaBytes) {
+    records_.reserve(episodeCount);
+    arena_.reserve(arenaBytes);
+
+    size_t slots = kMinGuidSlots;
+    while (slots < episodeCount * 2) {
+        slots *= 2;
+    }
+    if (slots > guidSlots_.size()) {
+        rehashGuids(slots);
+    }
+}
+
+void EpisodeStore::add(std::string_view title, std::string_view description, std::string_view url,
+                       std::string_view pubDate, std::string_view duration, std::string_view guid,
+                       bool descriptionEncoded) {
+    Record record;
+    record.fields[Title] = store(title);
+    record.fields[Description] = store(description);
+    record.fields[Url] = store(url);
+    record.fields[PubDate] = store(pubDate);
+    record.fields[Duration] = store(duration);
+    record.fields[Guid] = store(guid);
+    record.descriptionEncoded = descriptionEncoded;
+    records_.push_back(record);
+
+    if (!guid.empty()) {
+        indexGuid(guid, static_cast<uint32_t>(records_.size() - 1));
+    }
+}
+
+void EpisodeStore::add(const Episode& episode) {
+    add(episode.title, episode.description, episode.url, episode.pubDate, episode.duration, episode.guid);
+}
+
+void EpisodeStore::add(const EpisodeView& episode) {
+    add(episode.title, episode.rawDescription, episode.url, episode.pubDate, episode.duration,
+        episode.guid, episode.descriptionEncoded);
+}
+
+EpisodeView EpisodeStore::operator[](size_t index) const {
+    if (index >= records_.size()) {
+        throw std::out_of_range("Episode index out of range");
+    }
+
+    const Record& record = records_[index];
+    EpisodeView episode;
+    episode.title = view(record.fields[Title]);
+    episode.rawDescription = view(record.fields[Description]);
+    episode.url = view(record.fields[Url]);
+    episode.pubDate = view(record.fields[PubDate]);
+    episode.duration = view(record.fields[Duration]);
+    episode.guid = view(record.fields[Guid]);
+    episode.descriptionEncoded = record.descriptionEncoded;
+    return episode;
+}
+
+int EpisodeStore::findGuid(std::string_view guid) const {
+    if (guid.empty() || guidSlots_.empty()) {
+        return -1;
+    }
+
+    uint32_t hash = hashGuid(guid);
+    size_t mask = guidSlots_.size() - 1;
+    for (size_t i = hash & mask;; i = (i + 1) & mask) {
+        const GuidSlot& slot = guidSlots_[i];
+        if (slot.record == kEmptySlot) {
+            return -1;
+        }
+        if (slot.hash == hash && view(records_[slot.record].fields[Guid]) == guid) {
+            return static_cast<int>(slot.record);
+        }
+    }
+}
+
+void EpisodeStore::indexGuid(std::string_view guid, uint32_t record) {
+    if ((guidCount_ + 1) * 2 > guidSlots_.size()) {
+        rehashGuids(std::max(kMinGuidSlots, guidSlots_.size() * 2));
+    }
+
+    uint32_t hash = hashGuid(guid);
+    size_t mask = guidSlots_.size() - 1;
+    for (size_t i = hash & mask;; i = (i + 1) & mask) {
+        GuidSlot& slot = guidSlots_[i];
+        if (slot.record == kEmptySlot) {
+            slot = GuidSlot{hash, record};
+            guidCount_++;
+            return;
+        }
+        // Duplicate guids keep pointing at their first occurrence
+        if (slot.hash == hash && view(records_[slot.record].fields[Guid]) == guid) {
+            return;
+        }
+    }
+}
+
+void EpisodeStore::rehashGuids(size_t slotCount) {
+    std::vector<GuidSlot> old = std::move(guidSlots_);
+    guidSlots_.assign(slotCount, GuidSlot{0, kEmptySlot});
+
+    size_t mask = slotCount - 1;
+    for (const GuidSlot& slot : old) {
+        if (slot.record == kEmptySlot) continue;
+        size_t i = slot.hash & mask;
+        while (guidSlots_[i].record != kEmptySlot) {
+            i = (i + 1) & mask;
+        }
+        guidSlots_[i] = slot;
+    }
+}
+
+EpisodeStore::Span EpisodeStore::store(std::string_view value) {
+    Span span{static_cast<uint32_t>(arena_.size()), static_cast<uint32_t>(value.size())};
+    arena_.append(value.data(), value.size());
+    return span;
+}
+
+std::string_view EpisodeStore::view(const Span& span) const {
+    return std::string_view(arena_).substr(span.offset, span.length);
+}
+
+} // namespace core
+} // namespace podradio
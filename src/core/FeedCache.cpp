@@ -0,0 +1,181 @@
+#include "core/FeedCache.hpp"
+#include "core/Logger.hpp"
+#include "core/DebouncedWriter.hpp"
+#include <fstream>
+#include <filesystem>
+#include <algorithm>
+
+namespace podradio {
+namespace core {
+
+namespace {
+
+nlohmann::json episodeToJson(const EpisodeView& episode) {
+    nlohmann::json j{
+        {"title", episode.title},
+        {"description", episode.rawDescription},
+        {"url", episode.url},
+        {"pubDate", episode.pubDate},
+        {"duration", episode.duration},
+        {"guid", episode.guid}
+    };
+    if (episode.descriptionEncoded) {
+        j["descriptionEncoded"] = true;
+    }
+    return j;
+}
+
+void addEpisodeFromJson(EpisodeStore& episodes, const nlohmann::json& j) {
+    episodes.add(
+        j.value("title", ""),
+        j.value("description", ""),
+        j.at("url").get<std::string>(),
+        j.value("pubDate", ""),
+        j.value("duration", ""),
+        j.value("guid", ""),
+        j.value("descriptionEncoded", false)
+    );
+}
+
+} // namespace
+
+nlohmann::json FeedCacheEntry::toJson() const {
+    nlohmann::json j{
+        {"etag", etag},
+        {"lastModified", lastModified},
+        {"fetchedAt", std::chrono::duration_cast<std::chrono::seconds>(fetchedAt.time_since_epoch()).count()},
+        {"episodes", nlohmann::json::array()}
+    };
+
+    for (size_t i = 0; i < episodes.size(); ++i) {
+        j["episodes"].push_back(episodeToJson(episodes[i]));
+    }
+    if (truncated) {
+        j["truncated"] = true;
+    }
+    return j;
+}
+
+FeedCacheEntry FeedCacheEntry::fromJson(const nlohmann::json& j) {
+    FeedCacheEntry entry;
+    entry.etag = j.value("etag", "");
+    entry.lastModified = j.value("lastModified", "");
+    entry.fetchedAt = std::chrono::system_clock::from_time_t(j.value("fetchedAt", int64_t{0}));
+    entry.truncated = j.value("truncated", false);
+
+    if (j.contains("episodes") && j["episodes"].is_array()) {
+        for (const auto& episodeJson : j["episodes"]) {
+            addEpisodeFromJson(entry.episodes, episodeJson);
+        }
+    }
+    return entry;
+}
+
+FeedCache::FeedCache(const std::string& cacheDirectory)
+    : cacheDirectory_(cacheDirectory) {
+}
+
+std::shared_ptr<const FeedCacheEntry> FeedCache::get(const std::string& subscriptionId) {
+    uint64_t removals;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = entries_.find(subscriptionId);
+        if (it != entries_.end()) {
+            return it->second;
+        }
+        auto removed = removals_.find(subscriptionId);
+        removals = removed != removals_.end() ? removed->second : 0;
+    }
+
+    // Read and parse without the lock; a racing put() or load wins
+    std::ifstream file(entryPath(subscriptionId));
+    if (!file.is_open()) {
+        return nullptr;
+    }
+
+    std::shared_ptr<const FeedCacheEntry> entry;
+    try {
+        nlohmann::json j;
+        file >> j;
+        entry = std::make_shared<const FeedCacheEntry>(FeedCacheEntry::fromJson(j));
+    } catch (const std::exception& e) {
+        LOG_WARN << "Ignoring corrupt feed cache entry " << subscriptionId << ": " << e.what();
+        return nullptr;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    // A remove() since the read may have unlinked the file we parsed; don't
+    // bring its entry back
+    auto removed = removals_.find(subscriptionId);
+    if (removed != removals_.end() && removed->second != removals) {
+        return nullptr;
+    }
+    auto [it, inserted] = entries_.emplace(subscriptionId, entry);
+    if (inserted) {
+        auto& checkedAt = checkedAt_[subscriptionId];
+        checkedAt = std::max(checkedAt, entry->fetchedAt);
+    }
+    return it->second;
+}
+
+std::shared_ptr<const FeedCacheEntry> FeedCache::put(const std::string& subscriptionId, FeedCacheEntry entry) {
+    auto shared = std::make_shared<const FeedCacheEntry>(std::move(entry));
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        entries_[subscriptionId] = shared;
+        auto& checkedAt = checkedAt_[subscriptionId];
+        checkedAt = std::max(checkedAt, shared->fetchedAt);
+    }
+
+    try {
+        std::string content = shared->toJson().dump();
+
+        std::lock_guard<std::mutex> writeLock(writeMutex_);
+        {
+            // A newer put() or a remove() has superseded this entry; don't
+            // let a late write leave older content on disk
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = entries_.find(subscriptionId);
+            if (it == entries_.end() || it->second != shared) {
+                return shared;
+            }
+        }
+        std::filesystem::create_directories(cacheDirectory_);
+        writeFileAtomically(entryPath(subscriptionId), content);
+    } catch (const std::exception& e) {
+        LOG_ERROR << "Error saving feed cache entry " << subscriptionId << ": " << e.what();
+    }
+    return shared;
+}
+
+void FeedCache::remove(const std::string& subscriptionId) {
+    std::lock_guard<std::mutex> writeLock(writeMutex_);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        entries_.erase(subscriptionId);
+        checkedAt_.erase(subscriptionId);
+        removals_[subscriptionId]++;
+    }
+
+    std::error_code ec;
+    std::filesystem::remove(entryPath(subscriptionId), ec);
+}
+
+void FeedCache::touch(const std::string& subscriptionId, std::chrono::system_clock::time_point checkedAt) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& current = checkedAt_[subscriptionId];
+    current = std::max(current, checkedAt);
+}
+
+std::chrono::system_clock::time_point FeedCache::getCheckedAt(const std::string& subscriptionId) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = checkedAt_.find(subscriptionId);
+    return it != checkedAt_.end() ? it->second : std::chrono::system_clock::time_point{};
+}
+
+std::string FeedCache::entryPath(const std::string& subscriptionId) const {
+    return (std::filesystem::path(cacheDirectory_) / (subscriptionId + ".json")).string();
+}
+
+} // namespace core
+} // namespace podradio
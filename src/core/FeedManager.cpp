@@ -1,14 +1,48 @@
 #include "core/FeedManager.hpp"
+#include "core/Logger.hpp"
+#include "core/SubscriptionStore.hpp"
 #include <fstream>
-#include <iostream>
 #include <algorithm>
+#include <filesystem>
 #include <nlohmann/json.hpp>
 
 namespace podradio {
 namespace core {
 
+// Feed cache lives next to the subscription storage file
+static std::string cacheDirectoryFor(const std::string& storageFile) {
+    return (std::filesystem::path(storageFile).parent_path() / "feed_cache").string();
+}
+
+// Small record holding just the current selection, so navigating never
+// rewrites the subscription list
+static std::string indexFileFor(const std::string& storageFile) {
+    return std::filesystem::path(storageFile).replace_extension(".index.json").string();
+}
+
+// Items read by a head-only fetch; enough for playback and neighbour preloads
+static const size_t kHeadOnlyItems = 3;
+
+// New episodes first, followed by previously cached ones not superseded by them
+static EpisodeStore mergeEpisodes(const EpisodeStore& fresh, const EpisodeStore& cached) {
+    EpisodeStore merged;
+    merged.reserve(fresh.size() + cached.size(), fresh.arenaBytes() + cached.arenaBytes());
+    for (size_t i = 0; i < fresh.size(); ++i) {
+        merged.add(fresh[i]);
+    }
+    for (size_t i = 0; i < cached.size(); ++i) {
+        EpisodeView episode = cached[i];
+        if (fresh.findGuid(episode.guid) == -1) {
+            merged.add(episode);
+        }
+    }
+    return merged;
+}
+
 FeedManager::FeedManager(const std::string& storageFile) 
-    : currentIndex_(0), storageFile_(storageFile) {
+    : snapshot_(std::make_shared<const SubscriptionSnapshot>()), currentIndex_(0), storageFile_(storageFile), feedCache_(cacheDirectoryFor(storageFile)),
+      subscriptionsWriter_(storageFile, [this] { return serializeSubscriptions(); }),
+      indexWriter_(indexFileFor(storageFile), [this] { return serializeIndex(); }) {
     load();
 }
 
@@ -20,191 +54,416 @@ bool FeedManager::addPodcast(const std::string& name, const std::string& feedUrl
     if (name.empty() || feedUrl.empty()) {
         return false;
     }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto current = getSnapshot();
+    auto items = current->items();
+    auto index = std::make_shared<SubscriptionIndex>(*current->index());
+    if (!insertSubscription(items, *index, name, feedUrl, description)) {
+        LOG_INFO << "Podcast with this name or URL already exists";
+        return false;
+    }
     
-    // Check if podcast already exists
-    for (const auto& sub : subscriptions_) {
-        if (sub.feedUrl == feedUrl || sub.name == name) {
-            std::cout << "Podcast with this name or URL already exists\n";
-            return false;
+    publish(std::make_shared<const SubscriptionSnapshot>(std::move(items), std::move(index)));
+    subscriptionsWriter_.markDirty();
+    LOG_INFO << "Added podcast: " << name;
+    return true;
+}
+
+size_t FeedManager::addPodcasts(const std::vector<Subscription>& podcasts) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto current = getSnapshot();
+    auto items = current->items();
+    auto index = std::make_shared<SubscriptionIndex>(*current->index());
+    items.reserve(items.size() + podcasts.size());
+
+    size_t added = 0;
+    for (const auto& podcast : podcasts) {
+        if (!podcast.name.empty() && !podcast.feedUrl.empty() &&
+            insertSubscription(items, *index, podcast.name, podcast.feedUrl, podcast.description)) {
+            added++;
         }
     }
-    
-    // Create new subscription
-    Subscription newSub(name, feedUrl, description);
-    subscriptions_.push_back(newSub);
-    
-    // If this is the first subscription, set it as current
-    if (subscriptions_.size() == 1) {
-        currentIndex_ = 0;
+
+    if (added > 0) {
+        publish(std::make_shared<const SubscriptionSnapshot>(std::move(items), std::move(index)));
+        subscriptionsWriter_.markDirty();
     }
-    
-    save();
-    std::cout << "Added podcast: " << name << "\n";
-    return true;
+    LOG_INFO << "Imported " << added << " of " << podcasts.size() << " podcasts";
+    return added;
 }
 
 bool FeedManager::removePodcast(const std::string& identifier) {
-    int index = findSubscriptionIndex(identifier);
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto current = getSnapshot();
+    int index = current->find(identifier);
     if (index == -1) {
-        std::cout << "Podcast not found: " << identifier << "\n";
+        LOG_INFO << "Podcast not found: " << identifier;
         return false;
     }
     
-    std::string name = subscriptions_[index].name;
-    subscriptions_.erase(subscriptions_.begin() + index);
+    std::string name = (*current)[index].name;
+    feedCache_.remove((*current)[index].id);
+    auto items = current->items();
+    items.erase(items.begin() + index);
+    auto updated = std::make_shared<const SubscriptionSnapshot>(std::move(items)); // Positions shifted; reindex
+    publish(updated);
     
     // Adjust current index if necessary
-    if (currentIndex_ >= static_cast<int>(subscriptions_.size())) {
-        currentIndex_ = subscriptions_.empty() ? 0 : subscriptions_.size() - 1;
-    } else if (currentIndex_ > index) {
+    if (currentIndex_ > index) {
         currentIndex_--;
     }
     
-    ensureValidIndex();
-    save();
-    std::cout << "Removed podcast: " << name << "\n";
+    ensureValidIndex(*updated);
+    subscriptionsWriter_.markDirty();
+    indexWriter_.markDirty();
+    LOG_INFO << "Removed podcast: " << name;
     return true;
 }
 
+SubscriptionSnapshot::Ptr FeedManager::getSnapshot() const {
+    return std::atomic_load(&snapshot_);
+}
+
 std::vector<Subscription> FeedManager::getSubscriptions() const {
-    return subscriptions_;
+    auto snapshot = getSnapshot();
+    std::vector<Subscription> subscriptions;
+    subscriptions.reserve(snapshot->size());
+    for (const auto& item : *snapshot) {
+        subscriptions.push_back(*item);
+    }
+    return subscriptions;
 }
 
-std::optional<Subscription> FeedManager::getCurrentPodcast() const {
-    if (subscriptions_.empty() || currentIndex_ < 0 || currentIndex_ >= static_cast<int>(subscriptions_.size())) {
-        return std::nullopt;
+std::shared_ptr<const Subscription> FeedManager::getCurrentPodcast() const {
+    auto snapshot = getSnapshot();
+    int index = currentIndex_;
+    if (index < 0 || index >= static_cast<int>(snapshot->size())) {
+        return nullptr;
     }
-    return subscriptions_[currentIndex_];
+    return snapshot->at(index);
 }
 
 std::optional<Subscription> FeedManager::nextPodcast() {
-    if (subscriptions_.empty()) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto snapshot = getSnapshot();
+    if (snapshot->empty()) {
         return std::nullopt;
     }
     
-    currentIndex_ = (currentIndex_ + 1) % subscriptions_.size();
-    save();
-    return subscriptions_[currentIndex_];
+    int index = (currentIndex_ + 1) % static_cast<int>(snapshot->size());
+    currentIndex_ = index;
+    indexWriter_.markDirty();
+    return (*snapshot)[index];
 }
 
 std::optional<Subscription> FeedManager::previousPodcast() {
-    if (subscriptions_.empty()) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto snapshot = getSnapshot();
+    if (snapshot->empty()) {
         return std::nullopt;
     }
     
-    currentIndex_ = (currentIndex_ - 1 + subscriptions_.size()) % subscriptions_.size();
-    save();
-    return subscriptions_[currentIndex_];
+    int count = static_cast<int>(snapshot->size());
+    int index = (currentIndex_ - 1 + count) % count;
+    currentIndex_ = index;
+    indexWriter_.markDirty();
+    return (*snapshot)[index];
 }
 
 bool FeedManager::selectPodcast(const std::string& identifier) {
-    int index = findSubscriptionIndex(identifier);
+    std::lock_guard<std::mutex> lock(mutex_);
+    int index = getSnapshot()->find(identifier);
     if (index == -1) {
         return false;
     }
     
     currentIndex_ = index;
-    save();
+    indexWriter_.markDirty();
     return true;
 }
 
 std::optional<Episode> FeedManager::getLatestEpisode(const Subscription& subscription) {
-    try {
-        PodcastFeed feed;
-        feed.loadFromUrl(subscription.feedUrl);
-        
-        if (feed.getEpisodes().empty()) {
+    auto cached = feedCache_.get(subscription.id);
+
+    // Served straight from memory while the background refresher keeps it warm
+    if (cached && !cached->episodes.empty() && freshnessWindow_.count() > 0 &&
+        std::chrono::system_clock::now() - feedCache_.getCheckedAt(subscription.id) < freshnessWindow_) {
+        return cached->episodes.front().toEpisode();
+    }
+
+    // A complete cached list already makes the revalidation incremental
+    bool headOnly = !cached || cached->truncated;
+    auto entry = refreshFeed(subscription, headOnly);
+    if (entry) {
+        if (entry->episodes.empty()) {
             return std::nullopt;
         }
-        
-        return feed.getLatestEpisode();
-    } catch (const std::exception& e) {
-        std::cerr << "Error loading episodes for " << subscription.name << ": " << e.what() << "\n";
-        return std::nullopt;
+        return entry->episodes.front().toEpisode();
+    }
+
+    // Fall back to the last known episode list when the feed is unreachable
+    if (cached && !cached->episodes.empty()) {
+        return cached->episodes.front().toEpisode();
     }
+    return std::nullopt;
 }
 
-void FeedManager::save() {
+std::vector<Episode> FeedManager::getAdjacentEpisodes() {
+    std::vector<std::string> ids;
+    {
+        auto snapshot = getSnapshot();
+        int count = static_cast<int>(snapshot->size());
+        int current = currentIndex_;
+        if (count < 2 || current < 0 || current >= count) {
+            return {};
+        }
+        ids.push_back((*snapshot)[(current + 1) % count].id);
+        if (count > 2) {
+            ids.push_back((*snapshot)[(current - 1 + count) % count].id);
+        }
+    }
+
+    std::vector<Episode> episodes;
+    for (const auto& id : ids) {
+        auto cached = feedCache_.get(id);
+        if (cached && !cached->episodes.empty()) {
+            episodes.push_back(cached->episodes.front().toEpisode());
+        }
+    }
+    return episodes;
+}
+
+std::shared_ptr<const FeedCacheEntry> FeedManager::refreshFeed(const Subscription& subscription, bool headOnly,
+                                                               ThreadPool* parsePool) {
+    auto cached = feedCache_.get(subscription.id);
+    // A truncated entry is only a starting point: a full refresh must not get
+    // a 304 or stop at a known guid, or the back catalog would never arrive
+    bool usable = cached && (!cached->truncated || headOnly);
+
     try {
-        nlohmann::json j;
-        j["currentIndex"] = currentIndex_;
-        j["subscriptions"] = nlohmann::json::array();
-        
-        for (const auto& sub : subscriptions_) {
-            j["subscriptions"].push_back(sub.toJson());
+        FeedValidators validators;
+        if (usable) {
+            validators.etag = cached->etag;
+            validators.lastModified = cached->lastModified;
         }
-        
-        std::ofstream file(storageFile_);
-        if (file.is_open()) {
-            file << j.dump(4);
-            file.close();
+
+        // Feeds are newest-first: stop parsing (and downloading) at the first
+        // item we already have, so only new episodes are processed
+        FeedLoadOptions options;
+        if (usable && !cached->truncated && !cached->episodes.empty()) {
+            options.isKnownGuid = [&cached](std::string_view guid) {
+                return cached->episodes.findGuid(guid) != -1;
+            };
+        }
+        if (headOnly) {
+            options.maxItems = kHeadOnlyItems;
+        }
+        options.parsePool = parsePool;
+
+        PodcastFeed feed;
+        std::shared_ptr<const FeedCacheEntry> stored;
+        auto now = std::chrono::system_clock::now();
+        if (!feed.loadFromUrl(subscription.feedUrl, validators, options) && usable) {
+            // 304 Not Modified - the cached episode list is still current, so
+            // only the check time changes; the body on disk stays as it is
+            feedCache_.touch(subscription.id, now);
+            stored = cached;
         } else {
-            std::cerr << "Error: Could not open file for writing: " << storageFile_ << "\n";
+            FeedCacheEntry entry;
+            entry.etag = feed.getValidators().etag;
+            entry.lastModified = feed.getValidators().lastModified;
+            entry.fetchedAt = now;
+            if (feed.reachedKnownGuid() && usable) {
+                entry.episodes = mergeEpisodes(feed.getEpisodes(), cached->episodes);
+            } else {
+                entry.episodes = feed.getEpisodes();
+                // Hitting the item cap means the feed had more than we read
+                entry.truncated = headOnly && entry.episodes.size() >= kHeadOnlyItems;
+            }
+            stored = feedCache_.put(subscription.id, std::move(entry));
         }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto current = getSnapshot();
+            int index = current->find(subscription.id);
+            if (index != -1) {
+                auto updated = std::make_shared<Subscription>((*current)[index]);
+                updated->lastUpdated = now;
+                auto items = current->items();
+                items[index] = std::move(updated);
+                // Keys are unchanged, so the index is shared with the old snapshot
+                publish(std::make_shared<const SubscriptionSnapshot>(std::move(items), current->index()));
+                subscriptionsWriter_.markDirty();
+            }
+        }
+        
+        searchIndex_.setEpisodes(subscription.id, stored);
+        return stored;
     } catch (const std::exception& e) {
-        std::cerr << "Error saving subscriptions: " << e.what() << "\n";
+        LOG_ERROR << "Error loading episodes for " << subscription.name << ": " << e.what();
+        return nullptr;
+    }
+}
+
+SearchResults FeedManager::search(const SearchQuery& query) {
+    prepareSearch();
+    return searchIndex_.search(query);
+}
+
+void FeedManager::prepareSearch() {
+    // Cache entries may have to be read from disk; only the first call pays
+    for (const auto& id : searchIndex_.getUnindexedSubscriptions()) {
+        searchIndex_.fillEpisodes(id, feedCache_.get(id));
+    }
+}
+
+void FeedManager::save() {
+    subscriptionsWriter_.flush();
+    indexWriter_.flush();
+}
+
+std::string FeedManager::serializeSubscriptions() const {
+    auto snapshot = getSnapshot();
+    if (SubscriptionStore::isBinaryPath(storageFile_)) {
+        return SubscriptionStore::encode(*snapshot, currentIndex_);
+    }
+
+    nlohmann::json j;
+    j["currentIndex"] = currentIndex_.load();
+    j["subscriptions"] = nlohmann::json::array();
+    
+    for (const auto& sub : *snapshot) {
+        j["subscriptions"].push_back(sub->toJson());
+    }
+    return j.dump();
+}
+
+std::string FeedManager::serializeIndex() const {
+    auto snapshot = getSnapshot();
+    int index = currentIndex_;
+    nlohmann::json j;
+    j["currentIndex"] = index;
+    if (index >= 0 && index < static_cast<int>(snapshot->size())) {
+        j["currentId"] = (*snapshot)[index].id;
     }
+    return j.dump();
 }
 
 void FeedManager::load() {
+    std::lock_guard<std::mutex> lock(mutex_);
     try {
-        std::ifstream file(storageFile_);
-        if (!file.is_open()) {
+        int index = 0;
+        std::vector<SubscriptionSnapshot::Item> items;
+        bool loaded;
+        if (SubscriptionStore::isBinaryPath(storageFile_)) {
+            loaded = SubscriptionStore::load(storageFile_, items, index);
+            // First start on the binary store: carry over the JSON list
+            std::string jsonFile = std::filesystem::path(storageFile_).replace_extension(".json").string();
+            if (!loaded && !std::filesystem::exists(storageFile_) && loadJson(jsonFile, items, index)) {
+                LOG_INFO << "Importing subscriptions from " << jsonFile;
+                loaded = true;
+                subscriptionsWriter_.markDirty();
+            }
+        } else {
+            loaded = loadJson(storageFile_, items, index);
+        }
+        if (!loaded) {
             // File doesn't exist yet, start with empty subscriptions
-            subscriptions_.clear();
+            publish(std::make_shared<const SubscriptionSnapshot>());
             currentIndex_ = 0;
             return;
         }
+
+        auto snapshot = std::make_shared<const SubscriptionSnapshot>(std::move(items));
         
-        nlohmann::json j;
-        file >> j;
-        file.close();
-        
-        subscriptions_.clear();
-        
-        if (j.contains("currentIndex")) {
-            currentIndex_ = j["currentIndex"].get<int>();
-        }
-        
-        if (j.contains("subscriptions") && j["subscriptions"].is_array()) {
-            for (const auto& subJson : j["subscriptions"]) {
-                try {
-                    subscriptions_.push_back(Subscription::fromJson(subJson));
-                } catch (const std::exception& e) {
-                    std::cerr << "Error loading subscription: " << e.what() << "\n";
-                }
+        // Navigation only rewrites the index record, so it wins over the list's copy
+        std::ifstream indexFile(indexFileFor(storageFile_));
+        if (indexFile.is_open()) {
+            try {
+                nlohmann::json record;
+                indexFile >> record;
+                int byId = record.contains("currentId")
+                    ? snapshot->find(record["currentId"].get<std::string>()) : -1;
+                index = byId != -1 ? byId : record.value("currentIndex", index);
+            } catch (const std::exception& e) {
+                LOG_WARN << "Ignoring corrupt index file: " << e.what();
             }
         }
         
-        ensureValidIndex();
+        publish(snapshot);
+        currentIndex_ = index;
+        ensureValidIndex(*snapshot);
         
     } catch (const std::exception& e) {
-        std::cerr << "Error loading subscriptions: " << e.what() << "\n";
-        subscriptions_.clear();
+        LOG_ERROR << "Error loading subscriptions: " << e.what();
+        publish(std::make_shared<const SubscriptionSnapshot>());
         currentIndex_ = 0;
     }
 }
 
-int FeedManager::findSubscriptionIndex(const std::string& identifier) const {
-    for (size_t i = 0; i < subscriptions_.size(); ++i) {
-        if (subscriptions_[i].name == identifier || 
-            subscriptions_[i].feedUrl == identifier ||
-            subscriptions_[i].id == identifier) {
-            return static_cast<int>(i);
+bool FeedManager::loadJson(const std::string& path, std::vector<SubscriptionSnapshot::Item>& items, int& index) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    nlohmann::json j;
+    file >> j;
+    file.close();
+
+    if (j.contains("currentIndex")) {
+        index = j["currentIndex"].get<int>();
+    }
+
+    if (j.contains("subscriptions") && j["subscriptions"].is_array()) {
+        items.reserve(j["subscriptions"].size());
+        for (const auto& subJson : j["subscriptions"]) {
+            try {
+                items.push_back(std::make_shared<const Subscription>(Subscription::fromJson(subJson)));
+            } catch (const std::exception& e) {
+                LOG_ERROR << "Error loading subscription: " << e.what();
+            }
         }
     }
-    return -1;
+    return true;
+}
+
+int FeedManager::getCurrentIndex() const {
+    return currentIndex_;
+}
+
+int FeedManager::getSubscriptionCount() const {
+    return static_cast<int>(getSnapshot()->size());
+}
+
+void FeedManager::publish(SubscriptionSnapshot::Ptr snapshot) {
+    searchIndex_.syncSubscriptions(*snapshot);
+    std::atomic_store(&snapshot_, std::move(snapshot));
+}
+
+bool FeedManager::insertSubscription(std::vector<SubscriptionSnapshot::Item>& items, SubscriptionIndex& index,
+                                     const std::string& name, const std::string& feedUrl, const std::string& description) {
+    if (index.byName.count(name) || index.byFeedUrl.count(feedUrl)) {
+        return false;
+    }
+
+    auto subscription = std::make_shared<const Subscription>(name, feedUrl, description);
+    index.add(*subscription, items.size());
+    items.push_back(std::move(subscription));
+    return true;
 }
 
-void FeedManager::ensureValidIndex() {
-    if (subscriptions_.empty()) {
+void FeedManager::ensureValidIndex(const SubscriptionSnapshot& snapshot) {
+    if (snapshot.empty()) {
         currentIndex_ = 0;
     } else if (currentIndex_ < 0) {
         currentIndex_ = 0;
-    } else if (currentIndex_ >= static_cast<int>(subscriptions_.size())) {
-        currentIndex_ = subscriptions_.size() - 1;
+    } else if (currentIndex_ >= static_cast<int>(snapshot.size())) {
+        currentIndex_ = static_cast<int>(snapshot.size()) - 1;
     }
 }
 
 } // namespace core
-} // namespace podradio 
\ No newline at end of file
+} // namespace podradio 
@@ -0,0 +1,220 @@
+#include "core/FeedRefresher.hpp"
+#include "core/Logger.hpp"
+#include <random>
+#include <unordered_map>
+#include <deque>
+#include <algorithm>
+#include <vector>
+#include <ada.h>
+
+namespace podradio {
+namespace core {
+
+namespace {
+
+// Bounds on how long the adaptive scheduler sleeps between looking at the schedule
+const std::chrono::milliseconds kMinIdle{1000};
+const std::chrono::milliseconds kMaxIdle{60 * 1000};
+
+// Tracks completion of one refresh round across worker threads
+struct RefreshRound {
+    std::mutex mutex;
+    std::condition_variable done;
+    size_t pending = 0;
+    size_t succeeded = 0;
+};
+
+// Subscriptions sharing a host, drained by at most perHostLimit workers
+struct HostQueue {
+    std::mutex mutex;
+    std::deque<Subscription> subscriptions;
+};
+
+} // namespace
+
+FeedRefresher::FeedRefresher(FeedManager& feedManager, const RefreshOptions& options)
+    : feedManager_(feedManager), options_(options), schedule_(options) {
+    if (options_.perHostLimit == 0) {
+        options_.perHostLimit = 1;
+    }
+}
+
+FeedRefresher::~FeedRefresher() {
+    stop();
+}
+
+void FeedRefresher::start() {
+    if (running_) return;
+
+    running_ = true;
+    schedulerThread_ = std::thread(&FeedRefresher::schedulerLoop, this);
+}
+
+void FeedRefresher::stop() {
+    if (!running_) return;
+
+    {
+        std::lock_guard<std::mutex> lock(scheduleMutex_);
+        running_ = false;
+    }
+    scheduleCv_.notify_all();
+
+    if (schedulerThread_.joinable()) {
+        schedulerThread_.join();
+    }
+}
+
+size_t FeedRefresher::refreshAll() {
+    auto snapshot = feedManager_.getSnapshot();
+    schedule_.sync(*snapshot, std::chrono::system_clock::now());
+
+    std::vector<Subscription> subscriptions;
+    for (const auto& item : *snapshot) {
+        if (item->enabled) {
+            subscriptions.push_back(*item);
+        }
+    }
+
+    size_t succeeded = refreshSubscriptions(subscriptions);
+    // Persist the updated lastUpdated timestamps once per round
+    feedManager_.save();
+    return succeeded;
+}
+
+size_t FeedRefresher::refreshSubscriptions(const std::vector<Subscription>& subscriptions) {
+    std::lock_guard<std::mutex> roundLock(roundMutex_);
+    if (subscriptions.empty()) {
+        return 0;
+    }
+
+    // Group subscriptions by host so no single host gets hammered. Hosts
+    // are started in the order they first appear, so the schedule's most
+    // valuable feeds are fetched first.
+    std::unordered_map<std::string, std::shared_ptr<HostQueue>> hosts;
+    std::vector<std::shared_ptr<HostQueue>> hostOrder;
+    for (const auto& sub : subscriptions) {
+        auto& queue = hosts[hostOf(sub.feedUrl)];
+        if (!queue) {
+            queue = std::make_shared<HostQueue>();
+            hostOrder.push_back(queue);
+        }
+        queue->subscriptions.push_back(sub);
+    }
+
+    if (!pool_) {
+        pool_ = std::make_unique<ThreadPool>(options_.workerCount);
+    }
+
+    auto round = std::make_shared<RefreshRound>();
+    round->pending = subscriptions.size();
+
+    // Each lane drains its host's queue sequentially, so a host never sees
+    // more than perHostLimit concurrent requests.
+    for (auto& queue : hostOrder) {
+        size_t lanes = std::min(options_.perHostLimit, queue->subscriptions.size());
+        for (size_t i = 0; i < lanes; ++i) {
+            pool_->submit([this, round, queue] {
+                while (true) {
+                    Subscription sub;
+                    {
+                        std::lock_guard<std::mutex> lock(queue->mutex);
+                        if (queue->subscriptions.empty()) return;
+                        sub = std::move(queue->subscriptions.front());
+                        queue->subscriptions.pop_front();
+                    }
+
+                    // A throwing fetch or callback must not strand the rest of
+                    // this host's queue or leave the round waiting forever
+                    bool ok = false;
+                    try {
+                        // Workers whose lanes run dry help parse the remaining large feeds
+                        auto entry = feedManager_.refreshFeed(sub, false, pool_.get());
+                        if (entry) {
+                            schedule_.recordSuccess(sub.id, *entry, std::chrono::system_clock::now());
+                            ok = true;
+                            if (onFeedRefreshed_) {
+                                onFeedRefreshed_(sub, *entry);
+                            }
+                        }
+                    } catch (const std::exception& e) {
+                        LOG_ERROR << "Refreshing " << sub.name << " failed: " << e.what();
+                    }
+                    if (!ok) {
+                        schedule_.recordFailure(sub.id, std::chrono::system_clock::now());
+                    }
+
+                    std::lock_guard<std::mutex> lock(round->mutex);
+                    if (ok) round->succeeded++;
+                    if (--round->pending == 0) {
+                        round->done.notify_all();
+                    }
+                }
+            });
+        }
+    }
+
+    std::unique_lock<std::mutex> lock(round->mutex);
+    round->done.wait(lock, [&round] { return round->pending == 0; });
+    return round->succeeded;
+}
+
+void FeedRefresher::schedulerLoop() {
+    while (running_) {
+        std::chrono::milliseconds delay;
+        if (options_.adaptive) {
+            // Only the feeds that are due; lastUpdated is written behind
+            auto now = std::chrono::system_clock::now();
+            schedule_.sync(*feedManager_.getSnapshot(), now);
+
+            std::vector<Subscription> due;
+            for (const auto& item : schedule_.takeDue(now)) {
+                due.push_back(*item);
+            }
+            if (!due.empty()) {
+                size_t refreshed = refreshSubscriptions(due);
+                LOG_DEBUG << "Background refresh updated " << refreshed << " of " << due.size() << " due feeds";
+            }
+            delay = untilNextDue();
+        } else {
+            size_t refreshed = refreshAll();
+            LOG_INFO << "Background refresh updated " << refreshed << " feeds";
+            delay = nextDelay();
+        }
+
+        std::unique_lock<std::mutex> lock(scheduleMutex_);
+        scheduleCv_.wait_for(lock, delay, [this] { return !running_; });
+    }
+}
+
+std::chrono::milliseconds FeedRefresher::nextDelay() {
+    // Jitter spreads refreshes from many devices across the interval
+    static thread_local std::mt19937 rng{std::random_device{}()};
+    std::uniform_real_distribution<double> dist(1.0 - options_.jitter, 1.0 + options_.jitter);
+
+    auto base = std::chrono::duration_cast<std::chrono::milliseconds>(options_.interval);
+    return std::chrono::milliseconds(static_cast<int64_t>(base.count() * dist(rng)));
+}
+
+std::chrono::milliseconds FeedRefresher::untilNextDue() const {
+    // Wake up at least every kMaxIdle to pick up subscription changes
+    auto next = schedule_.nextDue();
+    auto now = std::chrono::system_clock::now();
+    if (next <= now) {
+        return kMinIdle;
+    }
+    if (next - now >= kMaxIdle) {
+        return kMaxIdle;
+    }
+    return std::max(kMinIdle, std::chrono::duration_cast<std::chrono::milliseconds>(next - now));
+}
+
+std::string FeedRefresher::hostOf(const std::string& url) {
+    auto parsed = ada::parse<ada::url>(url);
+    if (!parsed) {
+        return url;
+    }
+    return std::string(parsed->get_hostname());
+}
+
+} // namespace core
+} // namespace podradio
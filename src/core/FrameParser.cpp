@@ -0,0 +1,104 @@
+#include "core/FrameParser.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace podradio {
+namespace core {
+
+namespace {
+
+const size_t kLengthPrefixBytes = 4;
+
+} // namespace
+
+FrameParser::FrameParser(size_t maxFrameBytes, Framing framing)
+    : begin_(0), end_(0), scanned_(0), maxFrameBytes_(maxFrameBytes), framing_(framing) {
+}
+
+char* FrameParser::prepare(size_t bytes) {
+    if (begin_ == end_) {
+        begin_ = end_ = 0;
+    }
+    if (buffer_.size() - end_ < bytes && begin_ > 0) {
+        // Only the trailing partial frame is left to move
+        std::memmove(buffer_.data(), buffer_.data() + begin_, end_ - begin_);
+        end_ -= begin_;
+        begin_ = 0;
+    }
+    if (buffer_.size() - end_ < bytes) {
+        buffer_.resize(std::max(buffer_.size() * 2, end_ + bytes));
+    }
+    return buffer_.data() + end_;
+}
+
+void FrameParser::commit(size_t bytes) {
+    end_ = std::min(end_ + bytes, buffer_.size());
+}
+
+void FrameParser::append(std::string_view data) {
+    std::memcpy(prepare(data.size()), data.data(), data.size());
+    commit(data.size());
+}
+
+bool FrameParser::next(std::string_view& frame) {
+    while (!hasError()) {
+        const char* data = buffer_.data() + begin_;
+        size_t available = end_ - begin_;
+
+        if (framing_ == Framing::Line) {
+            const void* newline = std::memchr(data + scanned_, '\n', available - scanned_);
+            if (!newline) {
+                scanned_ = available;
+                if (available > maxFrameBytes_) {
+                    error_ = "Message too large";
+                }
+                return false;
+            }
+
+            size_t length = static_cast<const char*>(newline) - data;
+            begin_ += length + 1;
+            scanned_ = 0;
+            if (length > 0 && data[length - 1] == '\r') {
+                --length;
+            }
+            if (length == 0) {
+                continue; // Blank lines are keep-alives
+            }
+            frame = std::string_view(data, length);
+            return true;
+        }
+
+        if (available < kLengthPrefixBytes) {
+            return false;
+        }
+        const auto* prefix = reinterpret_cast<const unsigned char*>(data);
+        size_t length = (size_t(prefix[0]) << 24) | (size_t(prefix[1]) << 16) |
+                        (size_t(prefix[2]) << 8) | size_t(prefix[3]);
+        if (length > maxFrameBytes_) {
+            error_ = "Message too large";
+            return false;
+        }
+        if (available < kLengthPrefixBytes + length) {
+            return false;
+        }
+        begin_ += kLengthPrefixBytes + length;
+        frame = std::string_view(data + kLengthPrefixBytes, length);
+        return true;
+    }
+    return false;
+}
+
+void FrameParser::setFraming(Framing framing) {
+    framing_ = framing;
+    scanned_ = 0;
+}
+
+void FrameParser::appendLengthPrefix(std::string& out, uint32_t length) {
+    out.push_back(static_cast<char>((length >> 24) & 0xff));
+    out.push_back(static_cast<char>((length >> 16) & 0xff));
+    out.push_back(static_cast<char>((length >> 8) & 0xff));
+    out.push_back(static_cast<char>(length & 0xff));
+}
+
+} // namespace core
+} // namespace podradio
@@ -0,0 +1,139 @@
+#include "core/HttpClient.hpp"
+#include "core/Logger.hpp"
+#include <ada.h>
+
+namespace podradio {
+namespace core {
+
+namespace {
+
+const size_t kMaxIdlePerOrigin = 4;
+const long kDnsCacheSeconds = 300;
+
+} // namespace
+
+HttpClient::Lease::Lease(HttpClient& client, std::string origin, std::unique_ptr<cpr::Session> session)
+    : client_(&client), origin_(std::move(origin)), session_(std::move(session)) {
+}
+
+HttpClient::Lease::Lease(Lease&& other) noexcept
+    : client_(other.client_), origin_(std::move(other.origin_)), session_(std::move(other.session_)) {
+}
+
+HttpClient::Lease::~Lease() {
+    if (session_) {
+        client_->release(origin_, std::move(session_));
+    }
+}
+
+HttpClient& HttpClient::shared() {
+    static HttpClient client;
+    return client;
+}
+
+HttpClient::HttpClient() : share_(curl_share_init()) {
+    if (!share_) {
+        LOG_ERROR << "Failed to create curl share handle; connections won't be shared";
+        return;
+    }
+    curl_share_setopt(share_, CURLSHOPT_LOCKFUNC, &HttpClient::lockShared);
+    curl_share_setopt(share_, CURLSHOPT_UNLOCKFUNC, &HttpClient::unlockShared);
+    curl_share_setopt(share_, CURLSHOPT_USERDATA, this);
+    curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+    curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+    curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_CONNECT);
+}
+
+HttpClient::~HttpClient() {
+    // Sessions must detach from the share handle before it goes away
+    {
+        std::lock_guard<std::mutex> lock(poolMutex_);
+        idle_.clear();
+    }
+    if (share_) {
+        curl_share_cleanup(share_);
+    }
+}
+
+HttpClient::Lease HttpClient::acquire(const std::string& url) {
+    std::string origin = originOf(url);
+    std::unique_ptr<cpr::Session> session;
+    {
+        std::lock_guard<std::mutex> lock(poolMutex_);
+        auto it = idle_.find(origin);
+        if (it != idle_.end() && !it->second.empty()) {
+            session = std::move(it->second.back());
+            it->second.pop_back();
+        }
+    }
+    if (!session) {
+        session = createSession();
+    }
+    resetToDefaults(*session);
+    return Lease(*this, std::move(origin), std::move(session));
+}
+
+size_t HttpClient::getIdleSessionCount() const {
+    std::lock_guard<std::mutex> lock(poolMutex_);
+    size_t count = 0;
+    for (const auto& [origin, sessions] : idle_) {
+        count += sessions.size();
+    }
+    return count;
+}
+
+void HttpClient::release(const std::string& origin, std::unique_ptr<cpr::Session> session) {
+    std::lock_guard<std::mutex> lock(poolMutex_);
+    auto& sessions = idle_[origin];
+    if (sessions.size() < kMaxIdlePerOrigin) {
+        sessions.push_back(std::move(session));
+    }
+}
+
+std::unique_ptr<cpr::Session> HttpClient::createSession() {
+    auto session = std::make_unique<cpr::Session>();
+    CURL* handle = session->GetCurlHolder()->handle;
+    if (share_) {
+        curl_easy_setopt(handle, CURLOPT_SHARE, share_);
+    }
+    curl_easy_setopt(handle, CURLOPT_DNS_CACHE_TIMEOUT, kDnsCacheSeconds);
+    curl_easy_setopt(handle, CURLOPT_TCP_KEEPALIVE, 1L);
+    // Prefer an existing (possibly HTTP/2) connection over opening a new one
+    curl_easy_setopt(handle, CURLOPT_PIPEWAIT, 1L);
+    session->SetHttpVersion(cpr::HttpVersion{cpr::HttpVersionCode::VERSION_2_0_TLS});
+    return session;
+}
+
+void HttpClient::resetToDefaults(cpr::Session& session) {
+    // Options a previous lease may have changed
+    session.SetHeader(cpr::Header{});
+    session.SetTimeout(cpr::Timeout{0});
+    session.SetConnectTimeout(cpr::ConnectTimeout{0});
+    session.SetLowSpeed(cpr::LowSpeed{0, 0});
+    session.SetLimitRate(cpr::LimitRate{0, 0});
+    session.SetRedirect(cpr::Redirect{50L});
+    session.SetVerifySsl(cpr::VerifySsl{true});
+    // Download() leaves its callback installed and cpr skips its own body
+    // handling while one is set; the old closure refers to a dead stack frame
+    session.SetWriteCallback(cpr::WriteCallback{});
+    session.SetHeaderCallback(cpr::HeaderCallback{});
+}
+
+std::string HttpClient::originOf(const std::string& url) {
+    auto parsed = ada::parse<ada::url>(url);
+    if (!parsed) {
+        return url;
+    }
+    return std::string(parsed->get_protocol()) + "//" + parsed->get_host();
+}
+
+void HttpClient::lockShared(CURL*, curl_lock_data data, curl_lock_access, void* userptr) {
+    static_cast<HttpClient*>(userptr)->shareMutexes_[data].lock();
+}
+
+void HttpClient::unlockShared(CURL*, curl_lock_data data, void* userptr) {
+    static_cast<HttpClient*>(userptr)->shareMutexes_[data].unlock();
+}
+
+} // namespace core
+} // namespace podradio
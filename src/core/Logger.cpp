@@ -0,0 +1,226 @@
+#include "core/Logger.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+namespace podradio {
+namespace core {
+
+namespace {
+
+// How long the sink sleeps when idle; bounds the latency of a missed wakeup
+const auto kIdleWait = std::chrono::milliseconds(50);
+
+size_t roundUpToPowerOfTwo(size_t value) {
+    size_t result = 2;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+const char* journalPrefix(LogLevel level) {
+    switch (level) {
+        case LogLevel::Debug: return "<7>";
+        case LogLevel::Info: return "<6>";
+        case LogLevel::Warning: return "<4>";
+        case LogLevel::Error:
+        default: return "<3>";
+    }
+}
+
+} // namespace
+
+Logger& Logger::global() {
+    // Deliberately leaked: objects destroyed at exit may still log. The
+    // atexit hook writes what's pending and switches to synchronous output.
+    static Logger* logger = [] {
+        auto* instance = new Logger();
+        const char* env = std::getenv("PODRADIO_LOG_LEVEL");
+        LogLevel level;
+        if (env && parseLevel(env, level)) {
+            instance->setLevel(level);
+        }
+        std::atexit([] { Logger::global().shutdown(); });
+        return instance;
+    }();
+    return *logger;
+}
+
+bool Logger::parseLevel(const std::string& name, LogLevel& level) {
+    if (name == "debug") {
+        level = LogLevel::Debug;
+    } else if (name == "info") {
+        level = LogLevel::Info;
+    } else if (name == "warning" || name == "warn") {
+        level = LogLevel::Warning;
+    } else if (name == "error") {
+        level = LogLevel::Error;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+Logger::Logger(size_t capacity)
+    : mask_(roundUpToPowerOfTwo(capacity) - 1),
+      level_(static_cast<int>(LogLevel::Info)),
+      journalPrefixes_(std::getenv("JOURNAL_STREAM") != nullptr) {
+    slots_ = std::make_unique<Slot[]>(mask_ + 1);
+    for (size_t i = 0; i <= mask_; ++i) {
+        slots_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    thread_ = std::thread(&Logger::sinkLoop, this);
+}
+
+Logger::~Logger() {
+    shutdown();
+}
+
+void Logger::log(LogLevel level, std::string message) {
+    if (!enabled(level)) {
+        return;
+    }
+
+    if (stopping_.load(std::memory_order_acquire)) {
+        std::string out, err;
+        write(level, message, out, err);
+        std::lock_guard<std::mutex> lock(writeMutex_);
+        std::cout << out << std::flush;
+        std::cerr << err << std::flush;
+        return;
+    }
+
+    if (!tryPush(level, message)) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    if (sleeping_.load(std::memory_order_acquire)) {
+        wake_.notify_one();
+    }
+}
+
+// Bounded MPSC queue after Dmitry Vyukov: each slot's sequence number says
+// whether it is free for the producer at that position or ready for the consumer
+bool Logger::tryPush(LogLevel level, std::string& message) {
+    size_t pos = enqueuePos_.load(std::memory_order_relaxed);
+    Slot* slot;
+    while (true) {
+        slot = &slots_[pos & mask_];
+        size_t sequence = slot->sequence.load(std::memory_order_acquire);
+        auto diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+        if (diff == 0) {
+            if (enqueuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            return false; // Full
+        } else {
+            pos = enqueuePos_.load(std::memory_order_relaxed);
+        }
+    }
+
+    slot->level = level;
+    slot->message = std::move(message);
+    slot->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+bool Logger::tryPop(LogLevel& level, std::string& message) {
+    Slot& slot = slots_[dequeuePos_ & mask_];
+    if (slot.sequence.load(std::memory_order_acquire) != dequeuePos_ + 1) {
+        return false;
+    }
+    level = slot.level;
+    message = std::move(slot.message);
+    slot.message.clear();
+    slot.sequence.store(dequeuePos_ + mask_ + 1, std::memory_order_release);
+    ++dequeuePos_;
+    return true;
+}
+
+void Logger::write(LogLevel level, const std::string& message, std::string& out, std::string& err) const {
+    std::string& target = level >= LogLevel::Warning ? err : out;
+    if (journalPrefixes_) {
+        target += journalPrefix(level);
+    }
+    target += message;
+    target += '\n';
+}
+
+size_t Logger::drain() {
+    std::string out, err;
+    LogLevel level;
+    std::string message;
+    size_t count = 0;
+    while (tryPop(level, message)) {
+        write(level, message, out, err);
+        ++count;
+    }
+
+    uint64_t dropped = dropped_.load(std::memory_order_relaxed);
+    if (dropped != reportedDropped_) {
+        write(LogLevel::Warning, "Logger dropped " + std::to_string(dropped - reportedDropped_) + " messages",
+              out, err);
+        reportedDropped_ = dropped;
+    }
+
+    if (!out.empty() || !err.empty()) {
+        std::lock_guard<std::mutex> lock(writeMutex_);
+        if (!out.empty()) {
+            std::cout << out << std::flush;
+        }
+        if (!err.empty()) {
+            std::cerr << err << std::flush;
+        }
+    }
+    if (count > 0) {
+        written_.fetch_add(count, std::memory_order_release);
+        std::lock_guard<std::mutex> lock(mutex_);
+        drained_.notify_all();
+    }
+    return count;
+}
+
+void Logger::sinkLoop() {
+    while (true) {
+        if (drain() > 0) {
+            continue;
+        }
+        if (stopping_.load(std::memory_order_acquire)) {
+            break;
+        }
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        sleeping_.store(true, std::memory_order_release);
+        wake_.wait_for(lock, kIdleWait);
+        sleeping_.store(false, std::memory_order_relaxed);
+    }
+    drain(); // Producers that raced with stopping_
+}
+
+void Logger::flush() {
+    if (stopping_.load(std::memory_order_acquire)) {
+        return; // Writes are synchronous from here on
+    }
+    size_t target = enqueuePos_.load(std::memory_order_acquire);
+    std::unique_lock<std::mutex> lock(mutex_);
+    wake_.notify_one();
+    // Dropped messages never occupy a slot, so counting consumed slots is exact
+    drained_.wait_for(lock, std::chrono::seconds(2), [this, target] {
+        return written_.load(std::memory_order_acquire) >= target;
+    });
+}
+
+void Logger::shutdown() {
+    if (stopping_.exchange(true)) {
+        return;
+    }
+    wake_.notify_one();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+} // namespace core
+} // namespace podradio
@@ -0,0 +1,140 @@
+#include "core/Metrics.hpp"
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+namespace podradio {
+namespace core {
+
+size_t Histogram::bucketOf(uint64_t value) {
+    if (value < kSubBuckets) {
+        return static_cast<size_t>(value);
+    }
+    unsigned msb = 63 - static_cast<unsigned>(__builtin_clzll(value));
+    unsigned shift = msb - kSubBucketBits;
+    size_t sub = static_cast<size_t>(value >> shift) & (kSubBuckets - 1);
+    return (shift + 1) * kSubBuckets + sub;
+}
+
+uint64_t Histogram::bucketUpperBound(size_t bucket) {
+    if (bucket < kSubBuckets) {
+        return bucket;
+    }
+    unsigned shift = static_cast<unsigned>(bucket / kSubBuckets - 1);
+    uint64_t sub = bucket % kSubBuckets;
+    // Computed as lower bound plus width so the top bucket doesn't overflow
+    uint64_t lower = (kSubBuckets + sub) << shift;
+    return lower + ((uint64_t{1} << shift) - 1);
+}
+
+void Histogram::record(uint64_t value) {
+    buckets_[bucketOf(value)].fetch_add(1, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+    sum_.fetch_add(value, std::memory_order_relaxed);
+
+    uint64_t seen = min_.load(std::memory_order_relaxed);
+    while (value < seen && !min_.compare_exchange_weak(seen, value, std::memory_order_relaxed)) {}
+    seen = max_.load(std::memory_order_relaxed);
+    while (value > seen && !max_.compare_exchange_weak(seen, value, std::memory_order_relaxed)) {}
+}
+
+Histogram::Summary Histogram::summarize() const {
+    Summary summary;
+    uint64_t counts[kBuckets];
+    uint64_t total = 0;
+    for (size_t i = 0; i < kBuckets; ++i) {
+        counts[i] = buckets_[i].load(std::memory_order_relaxed);
+        total += counts[i];
+    }
+    if (total == 0) {
+        return summary;
+    }
+
+    summary.count = total;
+    summary.sum = sum_.load(std::memory_order_relaxed);
+    summary.min = min_.load(std::memory_order_relaxed);
+    summary.max = max_.load(std::memory_order_relaxed);
+
+    // Report each percentile as its bucket's upper bound, clamped to the observed max
+    struct Target { double quantile; uint64_t* out; };
+    Target targets[] = {{0.50, &summary.p50}, {0.90, &summary.p90}, {0.99, &summary.p99}};
+    uint64_t seen = 0;
+    size_t next = 0;
+    for (size_t i = 0; i < kBuckets && next < 3; ++i) {
+        seen += counts[i];
+        while (next < 3 && seen >= static_cast<uint64_t>(targets[next].quantile * total + 0.5)) {
+            *targets[next].out = std::min(bucketUpperBound(i), summary.max);
+            ++next;
+        }
+    }
+    return summary;
+}
+
+MetricsRegistry& MetricsRegistry::global() {
+    static MetricsRegistry registry;
+    return registry;
+}
+
+Counter& MetricsRegistry::counter(const std::string& name) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& slot = counters_[name];
+    if (!slot) {
+        slot = std::make_unique<Counter>();
+    }
+    return *slot;
+}
+
+Histogram& MetricsRegistry::histogram(const std::string& name) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& slot = histograms_[name];
+    if (!slot) {
+        slot = std::make_unique<Histogram>();
+    }
+    return *slot;
+}
+
+nlohmann::json MetricsRegistry::toJson() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    nlohmann::json j;
+    j["counters"] = nlohmann::json::object();
+    j["histograms"] = nlohmann::json::object();
+    for (const auto& [name, counter] : counters_) {
+        j["counters"][name] = counter->value();
+    }
+    for (const auto& [name, histogram] : histograms_) {
+        Histogram::Summary s = histogram->summarize();
+        j["histograms"][name] = {
+            {"count", s.count},
+            {"mean", s.count ? s.sum / s.count : 0},
+            {"min", s.min},
+            {"max", s.max},
+            {"p50", s.p50},
+            {"p90", s.p90},
+            {"p99", s.p99}
+        };
+    }
+    return j;
+}
+
+std::string MetricsRegistry::format() const {
+    nlohmann::json j = toJson();
+    std::ostringstream out;
+    out << "Counters:\n";
+    for (const auto& [name, value] : j["counters"].items()) {
+        out << "  " << std::left << std::setw(36) << name << value.get<uint64_t>() << "\n";
+    }
+    out << "Histograms:" << std::right << std::setw(35) << "count" << std::setw(10) << "p50"
+        << std::setw(10) << "p90" << std::setw(10) << "p99" << std::setw(12) << "max" << "\n";
+    for (const auto& [name, h] : j["histograms"].items()) {
+        out << "  " << std::left << std::setw(34) << name << std::right
+            << std::setw(10) << h["count"].get<uint64_t>()
+            << std::setw(10) << h["p50"].get<uint64_t>()
+            << std::setw(10) << h["p90"].get<uint64_t>()
+            << std::setw(10) << h["p99"].get<uint64_t>()
+            << std::setw(12) << h["max"].get<uint64_t>() << "\n";
+    }
+    return out.str();
+}
+
+} // namespace core
+} // namespace podradio
@@ -1,68 +1,88 @@
 #include "core/Player.hpp"
+#include "core/Logger.hpp"
+#include "core/HttpClient.hpp"
+#include "core/UrlClassifier.hpp"
+#include "core/Metrics.hpp"
 #include <stdexcept>
 #include <cstdlib>
-#include <iostream>
 #include <thread>
 #include <chrono>
+#include <future>
 #include <sstream>
+#include <iomanip>
 #include <algorithm>
+#include <utility>
 #include <cpr/cpr.h>
 #include <ada.h>
 
 namespace podradio {
 namespace core {
 
-// Helper function to clean and validate URLs using ada-url
-static std::string cleanAndValidateUrl(const std::string& url) {
-    if (url.empty()) {
-        return "";
-    }
-
-    // Trim whitespace
-    std::string cleaned = url;
-    cleaned.erase(0, cleaned.find_first_not_of(" \t\n\r"));
-    cleaned.erase(cleaned.find_last_not_of(" \t\n\r") + 1);
-
-    if (cleaned.empty()) {
-        return "";
-    }
+namespace {
 
-    // Basic URL validation without ada-url for now
-    if (cleaned.find("http://") != 0 && cleaned.find("https://") != 0) {
-        return "";
-    }
+struct PlayerMetrics {
+    Histogram& resolveUs = MetricsRegistry::global().histogram("player.resolve_us");
+    Histogram& redirectHops = MetricsRegistry::global().histogram("player.redirect_hops");
+    Counter& resolveCacheHits = MetricsRegistry::global().counter("player.resolve_cache_hits");
+    Histogram& timeToAudioUs = MetricsRegistry::global().histogram("player.time_to_first_audio_us");
+    Counter& startFailures = MetricsRegistry::global().counter("player.start_failures");
+    Counter& rebuffers = MetricsRegistry::global().counter("player.rebuffers");
+    Counter& bytesRead = MetricsRegistry::global().counter("player.bytes_read");
+};
 
-    return cleaned;
+PlayerMetrics& playerMetrics() {
+    static PlayerMetrics metrics;
+    return metrics;
 }
 
+} // namespace
+
 // Helper function to resolve URL redirects and get final media URL
 std::string Player::resolveMediaUrl(const std::string& url) {
     // Clean and validate the URL
-    std::string cleaned_url = cleanAndValidateUrl(url);
+    std::string cleaned_url = UrlClassifier::clean(url);
     
     if (cleaned_url.empty()) {
         throw std::runtime_error("Invalid or empty URL provided");
     }
 
+    // Tracking-prefix chains resolve to the same CDN URL for hours
+    if (auto cached = resolved_urls_->lookup(cleaned_url)) {
+        playerMetrics().resolveCacheHits.add();
+        return *cached;
+    }
+
+    ScopedTimer resolveTimer(playerMetrics().resolveUs);
+    if (auto resolved = followRedirects(cleaned_url)) {
+        resolved_urls_->store(cleaned_url, *resolved);
+        return *resolved;
+    }
+
+    // If all else fails, return the original URL and let VLC handle it
+    return cleaned_url;
+}
+
+std::optional<std::string> Player::followRedirects(const std::string& cleaned_url) {
     try {
-        // Use cpr for HTTP redirect resolution with better configuration
-        auto session = cpr::Session{};
-        session.SetUrl(cpr::Url{cleaned_url});
-        session.SetHeader(cpr::Header{
+        // Pooled session: tracking prefixes (podtrac, megaphone, ...) share a few hosts
+        auto session = HttpClient::shared().acquire(cleaned_url);
+        session->SetUrl(cpr::Url{cleaned_url});
+        session->SetHeader(cpr::Header{
             {"Accept", "audio/mpeg, audio/mp4, audio/*, application/octet-stream"},
             {"User-Agent", "Mozilla/5.0 (Macintosh; Intel Mac OS X 10_15_7) AppleWebKit/537.36 (KHTML, like Gecko) Chrome/91.0.4472.124 Safari/537.36"},
             {"Accept-Encoding", "gzip, deflate"},
             {"Connection", "keep-alive"},
             {"Cache-Control", "no-cache"}
         });
-        session.SetTimeout(cpr::Timeout{30000}); // 30 seconds
-        session.SetRedirect(cpr::Redirect{50L, true, false, cpr::PostRedirectFlags::POST_ALL});
-        session.SetVerifySsl(cpr::VerifySsl{false}); // For compatibility with some podcast services
+        session->SetTimeout(cpr::Timeout{30000}); // 30 seconds
+        session->SetRedirect(cpr::Redirect{50L, true, false, cpr::PostRedirectFlags::POST_ALL});
+        session->SetVerifySsl(cpr::VerifySsl{false}); // For compatibility with some podcast services
 
         // First try HEAD request to avoid downloading content
-        auto head_response = session.Head();
+        auto head_response = session->Head();
         
         if (head_response.status_code >= 200 && head_response.status_code < 300) {
+            playerMetrics().redirectHops.record(static_cast<uint64_t>(std::max(0L, head_response.redirect_count)));
             // Check if it's audio content
             auto content_type_it = head_response.header.find("content-type");
             if (content_type_it != head_response.header.end()) {
@@ -78,22 +98,22 @@ std::string Player::resolveMediaUrl(const std::string& url) {
         if (head_response.error.code != cpr::ErrorCode::OK && 
             head_response.error.message.find("SSL") != std::string::npos) {
             // Try with more relaxed SSL settings
-            session.SetVerifySsl(cpr::VerifySsl{false});
+            session->SetVerifySsl(cpr::VerifySsl{false});
             
-            auto retry_response = session.Head();
+            auto retry_response = session->Head();
             if (retry_response.status_code >= 200 && retry_response.status_code < 300) {
                 return retry_response.url.str();
             }
         }
         
         // If HEAD fails, try GET request with limited range
-        session.SetHeader(cpr::Header{
+        session->SetHeader(cpr::Header{
             {"Accept", "audio/mpeg, audio/mp4, audio/*, application/octet-stream"},
             {"User-Agent", "Mozilla/5.0 (Macintosh; Intel Mac OS X 10_15_7) AppleWebKit/537.36 (KHTML, like Gecko) Chrome/91.0.4472.124 Safari/537.36"},
             {"Range", "bytes=0-1023"}  // Just get first 1KB
         });
         
-        auto get_response = session.Get();
+        auto get_response = session->Get();
         
         if (get_response.status_code >= 200 && get_response.status_code < 300) {
             return get_response.url.str();
@@ -101,12 +121,12 @@ std::string Player::resolveMediaUrl(const std::string& url) {
         
         // If range request fails, try without range
         if (get_response.status_code == 416) { // Range not satisfiable
-            session.SetHeader(cpr::Header{
+            session->SetHeader(cpr::Header{
                 {"Accept", "audio/mpeg, audio/mp4, audio/*, application/octet-stream"},
                 {"User-Agent", "Mozilla/5.0 (Macintosh; Intel Mac OS X 10_15_7) AppleWebKit/537.36 (KHTML, like Gecko) Chrome/91.0.4472.124 Safari/537.36"}
             });
             
-            auto simple_response = session.Get();
+            auto simple_response = session->Get();
             if (simple_response.status_code >= 200 && simple_response.status_code < 300) {
                 return simple_response.url.str();
             }
@@ -114,18 +134,16 @@ std::string Player::resolveMediaUrl(const std::string& url) {
         
         // Try fallback approach for tracking URLs
         try {
-            // Create a new session with minimal requirements
-            auto fallback_session = cpr::Session{};
-            fallback_session.SetUrl(cpr::Url{cleaned_url});
-            fallback_session.SetHeader(cpr::Header{
+            // Same pooled connection, minimal request headers
+            session->SetHeader(cpr::Header{
                 {"User-Agent", "curl/7.68.0"},
                 {"Accept", "*/*"}
             });
-            fallback_session.SetTimeout(cpr::Timeout{10000}); // Shorter timeout
-            fallback_session.SetRedirect(cpr::Redirect{10L, true, false, cpr::PostRedirectFlags::POST_ALL});
-            fallback_session.SetVerifySsl(cpr::VerifySsl{false});
+            session->SetTimeout(cpr::Timeout{10000}); // Shorter timeout
+            session->SetRedirect(cpr::Redirect{10L, true, false, cpr::PostRedirectFlags::POST_ALL});
+            session->SetVerifySsl(cpr::VerifySsl{false});
             
-            auto fallback_response = fallback_session.Get();
+            auto fallback_response = session->Get();
             if (fallback_response.status_code >= 200 && fallback_response.status_code < 400) {
                 return fallback_response.url.str();
             }
@@ -133,152 +151,453 @@ std::string Player::resolveMediaUrl(const std::string& url) {
             // Fallback failed, continue to return original URL
         }
         
-        // If all else fails, return the original URL and let VLC handle it
-        return cleaned_url;
+        // Nothing worked; don't cache a failure
+        return std::nullopt;
         
     } catch (const std::exception& e) {
-        std::cerr << "Error resolving URL: " << e.what() << std::endl;
+        LOG_ERROR << "Error resolving URL: " << e.what();
         throw;
     }
 }
 
-Player::Player() : vlc_(nullptr), player_(nullptr), media_(nullptr), playing_(false) {
-    // Set VLC plugin path for macOS
-    #ifdef __APPLE__
-    setenv("VLC_PLUGIN_PATH", "/Applications/VLC.app/Contents/MacOS/plugins", 1);
-    #endif
-    
-    // Set up VLC command line arguments
-    const char* args[] = {
-        "--no-video",           // Disable video output
-        "--verbose=2",          // Increase verbosity for debugging
-        "--network-caching=3000" // Add network caching
-    };
-    
-    // Create VLC instance with arguments
-    vlc_ = libvlc_new(3, args);
-    if (!vlc_) {
-        throw std::runtime_error("Failed to initialize VLC");
-    }
+namespace {
 
-    // Create media player
-    player_ = libvlc_media_player_new(vlc_);
-    if (!player_) {
-        libvlc_release(vlc_);
-        throw std::runtime_error("Failed to create VLC media player");
-    }
+// Media player events Player reacts to
+const libvlc_event_type_t kPlayerEvents[] = {
+    libvlc_MediaPlayerOpening,
+    libvlc_MediaPlayerBuffering,
+    libvlc_MediaPlayerTimeChanged,
+    libvlc_MediaPlayerLengthChanged,
+    libvlc_MediaPlayerPlaying,
+    libvlc_MediaPlayerPaused,
+    libvlc_MediaPlayerStopped,
+    libvlc_MediaPlayerEndReached,
+    libvlc_MediaPlayerEncounteredError
+};
+
+// Events a standby (preloading) player reports readiness through
+const libvlc_event_type_t kStandbyEvents[] = {
+    libvlc_MediaPlayerPaused,
+    libvlc_MediaPlayerStopped,
+    libvlc_MediaPlayerEncounteredError
+};
+
+} // namespace
 
+Player::Player(const std::string& cachingProfile)
+    : player_(nullptr), media_(nullptr), playing_(false), resolved_urls_(std::make_shared<ResolvedUrlCache>()) {
+    setCachingProfile(cachingProfile);
+}
+
+void Player::configureOutput(libvlc_media_player_t* player) {
     // Set initial volume to 100%
-    libvlc_audio_set_volume(player_, 100);
+    libvlc_audio_set_volume(player, 100);
+    if (!audio_device_.empty()) {
+        libvlc_audio_output_device_set(player, nullptr, audio_device_.c_str());
+    }
+}
+
+void Player::ensureVlc() {
+    // A throw leaves the flag unset, so the next call retries
+    std::call_once(vlc_once_, [this] {
+        auto vlc = VlcInstance::get();
+
+        // Create media player
+        libvlc_media_player_t* player = libvlc_media_player_new(vlc.get());
+        if (!player) {
+            throw std::runtime_error("Failed to create VLC media player");
+        }
+
+        configureOutput(player);
+        attachEvents(player, false, this);
+
+        std::lock_guard<std::mutex> lock(control_mutex_);
+        vlc_ = std::move(vlc);
+        player_ = player;
+    });
+}
+
+void Player::warmUp() {
+    submitBackground([this] {
+        try {
+            ensureVlc();
+        } catch (const std::exception& e) {
+            LOG_ERROR << "VLC warm-up failed: " << e.what();
+        }
+    });
 }
 
 Player::~Player() {
+    // Abandon queued prefetches and wait for in-flight ones
+    if (resolver_pool_) {
+        resolver_pool_->clearPending();
+        resolver_pool_.reset();
+    }
+
+    // Release standby players
+    {
+        std::lock_guard<std::mutex> lock(preload_mutex_);
+        for (auto& slot : preload_slots_) {
+            if (slot.player) {
+                libvlc_media_player_stop(slot.player);
+                detachEvents(slot.player, true, &slot);
+                libvlc_media_player_release(slot.player);
+                slot.player = nullptr;
+            }
+        }
+    }
+
+    // Owners of a pending start callback may already be gone at shutdown
+    {
+        std::lock_guard<std::mutex> lock(start_mutex_);
+        pending_start_ = nullptr;
+    }
+
     stop();
     if (player_) {
+        detachEvents(player_, false, this);
         libvlc_media_player_release(player_);
     }
-    if (vlc_) {
-        libvlc_release(vlc_);
+}
+
+void Player::setCachingProfile(const std::string& name) {
+    const CachingProfile* profile = CachingProfile::find(name);
+    if (!profile) {
+        throw std::runtime_error("Unknown caching profile: " + name);
     }
+    caching_profile_ = profile->name;
+    media_options_ = profile->mediaOptions();
 }
 
 void Player::play(const std::string& url) {
-    // If already playing, stop first
-    if (playing_) {
-        stop();
+    playAndWait(url, "");
+}
+
+void Player::play(const Episode& episode) {
+    playAndWait(episode.url, episode.guid);
+}
+
+void Player::playAndWait(const std::string& url, const std::string& guid) {
+    // Empty string on success, error message otherwise
+    auto result = std::make_shared<std::promise<std::string>>();
+    std::future<std::string> started = result->get_future();
+
+    startPlayback(url, guid, [result](bool success, const std::string& error) {
+        result->set_value(success ? std::string() : error);
+    });
+
+    // A late completion after a timeout lands harmlessly in the shared promise
+    if (started.wait_for(std::chrono::seconds(5)) != std::future_status::ready) {
+        std::stringstream err;
+        err << "Failed to start playback within 5 seconds. ";
+        {
+            std::lock_guard<std::mutex> lock(control_mutex_);
+            err << "Final state: " << (player_ ? getStateString(libvlc_media_player_get_state(player_)) : "Uninitialized");
+        }
+        throw std::runtime_error(err.str());
     }
 
-    try {
-        // Resolve the media URL
-        std::string media_url;
+    std::string error = started.get();
+    if (!error.empty()) {
+        dumpMediaStats();
+        throw std::runtime_error("Playback failed: " + error);
+    }
+    LOG_INFO << "Playback started successfully";
+}
+
+void Player::playAsync(const std::string& url, StartCallback onStarted, CancelCheck cancelled) {
+    startPlayback(url, "", std::move(onStarted), cancelled);
+}
+
+void Player::playAsync(const Episode& episode, StartCallback onStarted, CancelCheck cancelled) {
+    startPlayback(episode.url, episode.guid, std::move(onStarted), cancelled);
+}
+
+void Player::startPlayback(const std::string& url, const std::string& guid, StartCallback onStarted,
+                           const CancelCheck& cancelled) {
+    auto requested = std::chrono::steady_clock::now();
+    if (cancelled && cancelled()) {
+        if (onStarted) onStarted(false, "Cancelled by a newer command");
+        return;
+    }
+    ensureVlc();
+    std::string cleaned_url = UrlClassifier::clean(url);
+
+    // :start-time makes VLC's first request a ranged one at the offset, so
+    // the part already heard is never downloaded again
+    int64_t start_ms = position_store_ && !guid.empty() ? position_store_->getResumePosition(guid) : 0;
+    if (start_ms > 0) {
+        LOG_INFO << "Resuming at " << start_ms / 1000 << "s";
+    }
+
+    // A downloaded copy beats any stream: no connect, no network buffering
+    std::string local_path = local_media_lookup_ ? local_media_lookup_(url) : "";
+    if (!local_path.empty()) {
+        LOG_INFO << "Playing local copy: " << local_path;
+    }
+
+    std::string media_url;
+    // Standbys are parked at the start, which is useless for a resume
+    bool use_preloaded = start_ms == 0 && hasPreloaded(cleaned_url);
+    // Resolve before taking the control lock: redirect chains can take
+    // seconds, and stop() or pause() from another thread must not wait on them
+    if (local_path.empty() && !use_preloaded) {
         try {
             media_url = resolveMediaUrl(url);
         } catch (const std::exception& resolve_error) {
-            std::cout << "URL resolution failed, using original URL" << std::endl;
+            LOG_INFO << "URL resolution failed, using original URL";
             media_url = url;
         }
+    }
 
-        // Create media from resolved URL
-        media_ = libvlc_media_new_location(vlc_, media_url.c_str());
-        if (!media_) {
-            throw std::runtime_error("Failed to create media from URL: " + media_url);
-        }
+    std::unique_lock<std::mutex> lock(control_mutex_);
 
-        // Set media options for better streaming
-        libvlc_media_add_option(media_, ":network-caching=5000");
-        libvlc_media_add_option(media_, ":file-caching=2000");
-        libvlc_media_add_option(media_, ":live-caching=2000");
-        libvlc_media_add_option(media_, ":sout-mux-caching=2000");
-        libvlc_media_add_option(media_, ":http-reconnect=true");
-        libvlc_media_add_option(media_, ":http-user-agent=Mozilla/5.0 (Macintosh; Intel Mac OS X 10_15_7) AppleWebKit/537.36");
-        libvlc_media_add_option(media_, ":http-referrer=");
-        libvlc_media_add_option(media_, ":network-timeout=30000");
-        
-        // Set the media to the player
-        libvlc_media_player_set_media(player_, media_);
-        
-        // Release the media (player retains its own reference)
-        libvlc_media_release(media_);
-        media_ = nullptr;
-
-        // Start playback
-        if (libvlc_media_player_play(player_) < 0) {
-            throw std::runtime_error("Failed to start playback");
-        }
+    // Resolution can take tens of seconds; a pause or stop issued meanwhile
+    // must not be undone by this request
+    if (cancelled && cancelled()) {
+        lock.unlock();
+        if (onStarted) onStarted(false, "Cancelled by a newer command");
+        return;
+    }
 
-        // Wait and check playback status
-        int retry_count = 0;
-        const int max_retries = 10;
-        bool playback_started = false;
+    // If already playing, stop first. Whoever waited on the old request
+    // hears about it once the lock is released.
+    StartCallback superseded;
+    if (playing_) {
+        superseded = stopLocked();
+    }
 
-        while (retry_count < max_retries) {
-            std::this_thread::sleep_for(std::chrono::milliseconds(500));
-            
-            libvlc_state_t state = libvlc_media_player_get_state(player_);
+    try {
+        // A preloaded standby already has the media opened and buffered
+        if (!local_path.empty() || !use_preloaded || !swapInPreloaded(cleaned_url)) {
+            if (!local_path.empty()) {
+                media_url = local_path;
+            } else if (media_url.empty()) {
+                media_url = url; // The standby was recycled meanwhile; let VLC follow redirects
+            }
 
-            if (state == libvlc_Playing) {
-                playback_started = true;
-                break;
-            } else if (state == libvlc_Error) {
-                // Get error information
-                libvlc_media_t* current_media = libvlc_media_player_get_media(player_);
-                if (current_media) {
-                    libvlc_media_stats_t stats;
-                    if (libvlc_media_get_stats(current_media, &stats)) {
-                        std::cerr << "Media statistics:" << std::endl;
-                        std::cerr << "  Bytes read: " << stats.i_read_bytes << std::endl;
-                        std::cerr << "  Input bitrate: " << stats.f_input_bitrate << std::endl;
-                        std::cerr << "  Demux bytes read: " << stats.i_demux_read_bytes << std::endl;
-                        std::cerr << "  Demux bitrate: " << stats.f_demux_bitrate << std::endl;
-                    }
-                    libvlc_media_release(current_media);
-                }
-                throw std::runtime_error("Playback failed: player reported error state");
+            // Create media from the local file or resolved URL
+            media_ = createMedia(media_url, !local_path.empty(), start_ms);
+            if (!media_) {
+                throw std::runtime_error("Failed to create media from URL: " + media_url);
             }
-            
-            retry_count++;
+
+            // Set the media to the player
+            libvlc_media_player_set_media(player_, media_);
+
+            // Release the media (player retains its own reference)
+            libvlc_media_release(media_);
+            media_ = nullptr;
         }
 
-        if (!playback_started) {
-            std::stringstream err;
-            err << "Failed to start playback after " << max_retries << " attempts. ";
-            err << "Final state: " << getStateString(libvlc_media_player_get_state(player_));
-            throw std::runtime_error(err.str());
+        {
+            std::lock_guard<std::mutex> lock(status_mutex_);
+            tracked_guid_ = guid;
         }
 
-        playing_ = true;
-        std::cout << "Playback started successfully" << std::endl;
+        // Install the completion before starting so the Playing event can't be missed
+        {
+            std::lock_guard<std::mutex> lock(start_mutex_);
+            StartCallback previous = std::exchange(pending_start_, std::move(onStarted));
+            if (previous) {
+                superseded = std::move(previous);
+            }
+            start_requested_ = requested;
+        }
+
+        // Start playback
+        if (libvlc_media_player_play(player_) < 0) {
+            std::lock_guard<std::mutex> lock(start_mutex_);
+            pending_start_ = nullptr;
+            throw std::runtime_error("Failed to start playback");
+        }
     } catch (const std::exception& e) {
         if (media_) {
             libvlc_media_release(media_);
             media_ = nullptr;
         }
+        lock.unlock();
+        if (superseded) {
+            superseded(false, "Superseded by a newer playback request");
+        }
         throw;
     }
+
+    lock.unlock();
+    if (superseded) {
+        superseded(false, "Superseded by a newer playback request");
+    }
+}
+
+libvlc_media_t* Player::createMedia(const std::string& media_url, bool isLocalFile, int64_t startMs) {
+    libvlc_media_t* media = isLocalFile
+        ? libvlc_media_new_path(vlc_.get(), media_url.c_str())
+        : libvlc_media_new_location(vlc_.get(), media_url.c_str());
+    if (!media) {
+        return nullptr;
+    }
+
+    // Streaming options from the selected caching profile
+    for (const auto& option : media_options_) {
+        libvlc_media_add_option(media, option.c_str());
+    }
+    if (startMs > 0) {
+        std::ostringstream option;
+        option << ":start-time=" << startMs / 1000 << '.' << std::setw(3) << std::setfill('0') << startMs % 1000;
+        libvlc_media_add_option(media, option.str().c_str());
+    }
+    return media;
+}
+
+void Player::handleVlcEvent(const libvlc_event_t* event, void* userData) {
+    // Runs on a libvlc thread: only update state, never call back into libvlc
+    auto* self = static_cast<Player*>(userData);
+    switch (event->type) {
+        case libvlc_MediaPlayerOpening:
+            self->updateStatus([](PlaybackStatus& status) {
+                status.state = "opening";
+                status.positionMs = 0;
+                status.lengthMs = 0;
+                status.buffering = 0.0f;
+            });
+            break;
+        case libvlc_MediaPlayerBuffering: {
+            float cache = event->u.media_player_buffering.new_cache;
+            self->updateStatus([cache](PlaybackStatus& status) {
+                status.buffering = cache;
+                if (cache < 100.0f && status.state == "playing") {
+                    playerMetrics().rebuffers.add(); // Stalled mid-playback, not the initial fill
+                }
+                if (cache < 100.0f && status.state != "paused") {
+                    status.state = "buffering";
+                } else if (cache >= 100.0f && status.state == "buffering") {
+                    status.state = "playing";
+                }
+            });
+            break;
+        }
+        case libvlc_MediaPlayerTimeChanged: {
+            int64_t time = event->u.media_player_time_changed.new_time;
+            self->updateStatus([time](PlaybackStatus& status) { status.positionMs = time; });
+            self->recordPosition(false);
+            break;
+        }
+        case libvlc_MediaPlayerLengthChanged: {
+            int64_t length = event->u.media_player_length_changed.new_length;
+            self->updateStatus([length](PlaybackStatus& status) { status.lengthMs = length; });
+            break;
+        }
+        case libvlc_MediaPlayerPlaying:
+            self->playing_ = true;
+            self->updateStatus([](PlaybackStatus& status) { status.state = "playing"; });
+            self->completeStart(true, "");
+            break;
+        case libvlc_MediaPlayerEncounteredError:
+            self->playing_ = false;
+            self->updateStatus([](PlaybackStatus& status) { status.state = "error"; });
+            self->completeStart(false, "player reported error state");
+            break;
+        case libvlc_MediaPlayerEndReached:
+            self->playing_ = false;
+            self->updateStatus([](PlaybackStatus& status) { status.state = "ended"; });
+            self->recordPosition(true);
+            self->completeStart(false, "media ended before playback started");
+            break;
+        case libvlc_MediaPlayerPaused:
+            self->playing_ = false;
+            self->updateStatus([](PlaybackStatus& status) { status.state = "paused"; });
+            break;
+        case libvlc_MediaPlayerStopped:
+            self->playing_ = false;
+            self->updateStatus([](PlaybackStatus& status) { status.state = "stopped"; });
+            break;
+        default:
+            break;
+    }
+}
+
+void Player::updateStatus(const std::function<void(PlaybackStatus&)>& change) {
+    std::lock_guard<std::mutex> lock(status_mutex_);
+    change(status_);
+    if (on_status_changed_) {
+        on_status_changed_(status_);
+    }
+}
+
+void Player::recordPosition(bool finished) {
+    if (!position_store_) {
+        return;
+    }
+
+    std::string guid;
+    PlaybackStatus status;
+    {
+        std::lock_guard<std::mutex> lock(status_mutex_);
+        guid = tracked_guid_;
+        status = status_;
+    }
+    if (guid.empty()) {
+        return;
+    }
+
+    if (finished) {
+        position_store_->markFinished(guid);
+    } else if (status.state == "playing") {
+        // Ticks while opening report 0 and would overwrite the saved position
+        position_store_->update(guid, status.positionMs, status.lengthMs);
+    }
+}
+
+PlaybackStatus Player::getStatus() const {
+    std::lock_guard<std::mutex> lock(status_mutex_);
+    return status_;
+}
+
+void Player::setOnStatusChanged(std::function<void(const PlaybackStatus&)> callback) {
+    std::lock_guard<std::mutex> lock(status_mutex_);
+    on_status_changed_ = std::move(callback);
+}
+
+void Player::completeStart(bool success, const std::string& error) {
+    StartCallback callback = takePendingStart(success);
+    if (callback) {
+        callback(success, error);
+    }
+}
+
+Player::StartCallback Player::takePendingStart(bool success) {
+    std::lock_guard<std::mutex> lock(start_mutex_);
+    StartCallback callback = std::exchange(pending_start_, nullptr);
+    if (callback && success) {
+        playerMetrics().timeToAudioUs.record(ScopedTimer::elapsedUs(start_requested_));
+    } else if (callback) {
+        playerMetrics().startFailures.add();
+    }
+    return callback;
+}
+
+void Player::dumpMediaStats() {
+    std::lock_guard<std::mutex> lock(control_mutex_);
+    if (!player_) {
+        return;
+    }
+    libvlc_media_t* current_media = libvlc_media_player_get_media(player_);
+    if (!current_media) {
+        return;
+    }
+    libvlc_media_stats_t stats;
+    if (libvlc_media_get_stats(current_media, &stats)) {
+        LOG_INFO << "Media statistics:"
+                 << "\n  Bytes read: " << stats.i_read_bytes
+                 << "\n  Input bitrate: " << stats.f_input_bitrate
+                 << "\n  Demux bytes read: " << stats.i_demux_read_bytes
+                 << "\n  Demux bitrate: " << stats.f_demux_bitrate;
+    }
+    libvlc_media_release(current_media);
 }
 
 void Player::playPodcastFeed(const std::string& feedUrl) {
-    std::cout << "Loading podcast feed..." << std::endl;
+    LOG_INFO << "Loading podcast feed...";
     
     try {
         // Load and parse the feed
@@ -287,17 +606,220 @@ void Player::playPodcastFeed(const std::string& feedUrl) {
         // Get the latest episode
         current_episode_ = podcast_feed_.getLatestEpisode();
         
-        std::cout << "Playing: " << current_episode_.title << std::endl;
+        LOG_INFO << "Playing: " << current_episode_.title;
         
         // Play the episode's audio URL
-        play(current_episode_.url);
+        play(current_episode_);
     } catch (const std::exception& e) {
-        std::cerr << "Failed to play podcast feed: " << e.what() << std::endl;
+        LOG_ERROR << "Failed to play podcast feed: " << e.what();
         throw;
     }
 }
 
+void Player::prefetchMediaUrl(const std::string& url) {
+    std::string cleaned_url = UrlClassifier::clean(url);
+    if (cleaned_url.empty() || resolved_urls_->lookup(cleaned_url)) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(resolver_mutex_);
+        if (!resolving_.insert(cleaned_url).second) {
+            return; // Already being resolved
+        }
+    }
+
+    submitBackground([this, cleaned_url] {
+        try {
+            resolveMediaUrl(cleaned_url);
+        } catch (const std::exception& e) {
+            LOG_ERROR << "Background URL resolution failed: " << e.what();
+        }
+
+        std::lock_guard<std::mutex> lock(resolver_mutex_);
+        resolving_.erase(cleaned_url);
+    });
+}
+
+void Player::preload(const std::vector<std::string>& urls) {
+    // Standby players need libvlc; an empty list only recycles existing slots
+    if (!urls.empty()) {
+        try {
+            ensureVlc();
+        } catch (const std::exception& e) {
+            LOG_WARN << "Cannot preload: " << e.what();
+            return;
+        }
+    }
+
+    std::vector<std::string> wanted;
+    for (const auto& url : urls) {
+        std::string cleaned_url = UrlClassifier::clean(url);
+        if (!cleaned_url.empty() && wanted.size() < kPreloadSlots &&
+            std::find(wanted.begin(), wanted.end(), cleaned_url) == wanted.end()) {
+            wanted.push_back(cleaned_url);
+        }
+    }
+
+    std::vector<std::pair<PreloadSlot*, std::string>> to_prepare;
+    {
+        std::lock_guard<std::mutex> lock(preload_mutex_);
+
+        // Recycle slots holding URLs that are no longer adjacent
+        for (auto& slot : preload_slots_) {
+            if (!slot.url.empty() && std::find(wanted.begin(), wanted.end(), slot.url) == wanted.end()) {
+                libvlc_media_player_stop(slot.player);
+                slot.url.clear();
+                slot.ready = false;
+            }
+        }
+
+        for (const auto& url : wanted) {
+            auto held = std::find_if(preload_slots_.begin(), preload_slots_.end(),
+                                     [&url](const PreloadSlot& slot) { return slot.url == url; });
+            if (held != preload_slots_.end()) {
+                continue;
+            }
+
+            auto free_slot = std::find_if(preload_slots_.begin(), preload_slots_.end(),
+                                          [](const PreloadSlot& slot) { return slot.url.empty(); });
+            if (free_slot == preload_slots_.end()) {
+                break;
+            }
+            if (!free_slot->player) {
+                free_slot->player = libvlc_media_player_new(vlc_.get());
+                if (!free_slot->player) {
+                    LOG_ERROR << "Failed to create standby media player";
+                    break;
+                }
+                configureOutput(free_slot->player); // Swapped in later, so same device
+                attachEvents(free_slot->player, true, &*free_slot);
+            }
+            free_slot->url = url;
+            free_slot->ready = false;
+            to_prepare.emplace_back(&*free_slot, url);
+        }
+    }
+
+    for (const auto& [slot, url] : to_prepare) {
+        submitBackground([this, slot = slot, url = url] { prepareSlot(slot, url); });
+    }
+}
+
+void Player::prepareSlot(PreloadSlot* slot, const std::string& url) {
+    std::string media_url;
+    try {
+        media_url = resolveMediaUrl(url);
+    } catch (const std::exception& e) {
+        media_url = url;
+    }
+
+    std::lock_guard<std::mutex> lock(preload_mutex_);
+    if (slot->url != url) {
+        return; // Retargeted while resolving
+    }
+
+    libvlc_media_t* media = createMedia(media_url);
+    if (!media) {
+        slot->url.clear();
+        return;
+    }
+
+    // Open, probe and buffer, then hold at the first frame without output
+    libvlc_media_add_option(media, ":start-paused");
+    libvlc_media_player_set_media(slot->player, media);
+    libvlc_media_release(media);
+
+    if (libvlc_media_player_play(slot->player) < 0) {
+        LOG_ERROR << "Failed to preload " << url;
+        slot->url.clear();
+    }
+}
+
+bool Player::hasPreloaded(const std::string& cleaned_url) {
+    if (cleaned_url.empty()) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(preload_mutex_);
+    return std::any_of(preload_slots_.begin(), preload_slots_.end(), [&cleaned_url](const PreloadSlot& slot) {
+        return slot.url == cleaned_url && slot.ready;
+    });
+}
+
+bool Player::swapInPreloaded(const std::string& cleaned_url) {
+    if (cleaned_url.empty()) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(preload_mutex_);
+    for (auto& slot : preload_slots_) {
+        if (slot.url != cleaned_url || !slot.ready) {
+            continue;
+        }
+
+        // The outgoing player becomes the slot's standby
+        libvlc_media_player_t* previous = player_;
+        recordBytesRead(previous);
+        libvlc_media_player_stop(previous);
+        detachEvents(previous, false, this);
+        detachEvents(slot.player, true, &slot);
+
+        player_ = slot.player;
+        attachEvents(player_, false, this);
+
+        slot.player = previous;
+        slot.url.clear();
+        slot.ready = false;
+        attachEvents(slot.player, true, &slot);
+
+        LOG_INFO << "Switching to preloaded media";
+        return true;
+    }
+    return false;
+}
+
+void Player::handleStandbyEvent(const libvlc_event_t* event, void* userData) {
+    auto* slot = static_cast<PreloadSlot*>(userData);
+    // :start-paused parks the input once it is open and buffered
+    slot->ready = event->type == libvlc_MediaPlayerPaused;
+}
+
+void Player::attachEvents(libvlc_media_player_t* player, bool standby, void* userData) {
+    libvlc_event_manager_t* events = libvlc_media_player_event_manager(player);
+    if (standby) {
+        for (libvlc_event_type_t type : kStandbyEvents) {
+            libvlc_event_attach(events, type, &Player::handleStandbyEvent, userData);
+        }
+    } else {
+        for (libvlc_event_type_t type : kPlayerEvents) {
+            libvlc_event_attach(events, type, &Player::handleVlcEvent, userData);
+        }
+    }
+}
+
+void Player::detachEvents(libvlc_media_player_t* player, bool standby, void* userData) {
+    libvlc_event_manager_t* events = libvlc_media_player_event_manager(player);
+    if (standby) {
+        for (libvlc_event_type_t type : kStandbyEvents) {
+            libvlc_event_detach(events, type, &Player::handleStandbyEvent, userData);
+        }
+    } else {
+        for (libvlc_event_type_t type : kPlayerEvents) {
+            libvlc_event_detach(events, type, &Player::handleVlcEvent, userData);
+        }
+    }
+}
+
+void Player::submitBackground(std::function<void()> task) {
+    std::lock_guard<std::mutex> lock(resolver_mutex_);
+    if (!resolver_pool_) {
+        resolver_pool_ = std::make_unique<ThreadPool>(2);
+    }
+    resolver_pool_->submit(std::move(task));
+}
+
 void Player::pause() {
+    std::lock_guard<std::mutex> lock(control_mutex_);
     if (!playing_) return;
     
     if (player_) {
@@ -307,13 +829,44 @@ void Player::pause() {
 }
 
 void Player::stop() {
+    StartCallback stopped;
+    {
+        std::lock_guard<std::mutex> lock(control_mutex_);
+        stopped = stopLocked();
+    }
+    if (stopped) {
+        stopped(false, "Playback stopped");
+    }
+}
+
+Player::StartCallback Player::stopLocked() {
     if (player_) {
+        recordBytesRead(player_);
         libvlc_media_player_stop(player_);
         playing_ = false;
     }
+    return takePendingStart(false);
+}
+
+void Player::recordBytesRead(libvlc_media_player_t* player) {
+    // Stats survive until the media is replaced; an idle player was already counted
+    libvlc_state_t state = libvlc_media_player_get_state(player);
+    if (state == libvlc_NothingSpecial || state == libvlc_Stopped) {
+        return;
+    }
+    libvlc_media_t* current_media = libvlc_media_player_get_media(player);
+    if (!current_media) {
+        return;
+    }
+    libvlc_media_stats_t stats;
+    if (libvlc_media_get_stats(current_media, &stats) && stats.i_read_bytes > 0) {
+        playerMetrics().bytesRead.add(static_cast<uint64_t>(stats.i_read_bytes));
+    }
+    libvlc_media_release(current_media);
 }
 
 bool Player::isPlaying() const {
+    std::lock_guard<std::mutex> lock(control_mutex_);
     return playing_ && player_ && libvlc_media_player_is_playing(player_);
 }
 
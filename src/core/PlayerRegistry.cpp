@@ -0,0 +1,97 @@
+#include "core/PlayerRegistry.hpp"
+#include <stdexcept>
+
+namespace podradio {
+namespace core {
+
+PlayerRegistry::PlayerRegistry(const std::string& cachingProfile)
+    : cachingProfile_(cachingProfile), resolvedUrls_(std::make_shared<ResolvedUrlCache>()) {
+    if (!CachingProfile::find(cachingProfile)) {
+        throw std::runtime_error("Unknown caching profile: " + cachingProfile);
+    }
+}
+
+Player& PlayerRegistry::add(const std::string& zone, const std::string& audioDevice) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return addLocked(zone, audioDevice);
+}
+
+Player& PlayerRegistry::addLocked(const std::string& zone, const std::string& audioDevice) {
+    if (zone.empty()) {
+        throw std::runtime_error("Zone name must not be empty");
+    }
+    for (const auto& existing : zones_) {
+        if (existing.name == zone) {
+            throw std::runtime_error("Zone already exists: " + zone);
+        }
+    }
+
+    auto player = std::make_unique<Player>(cachingProfile_);
+    player->setAudioDevice(audioDevice);
+    player->shareResolvedUrls(resolvedUrls_);
+    zones_.push_back({zone, std::move(player)});
+    return *zones_.back().player;
+}
+
+Player* PlayerRegistry::find(const std::string& zone) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (zone.empty()) {
+        return zones_.empty() ? nullptr : zones_.front().player.get();
+    }
+    // A handful of zones at most, so a scan beats hashing
+    for (const auto& existing : zones_) {
+        if (existing.name == zone) {
+            return existing.player.get();
+        }
+    }
+    return nullptr;
+}
+
+Player& PlayerRegistry::getDefault() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (zones_.empty()) {
+        return addLocked(kDefaultZone, "");
+    }
+    return *zones_.front().player;
+}
+
+std::string PlayerRegistry::getDefaultName() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return zones_.empty() ? std::string(kDefaultZone) : zones_.front().name;
+}
+
+std::vector<std::string> PlayerRegistry::getZoneNames() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<std::string> names;
+    names.reserve(zones_.size());
+    for (const auto& zone : zones_) {
+        names.push_back(zone.name);
+    }
+    return names;
+}
+
+size_t PlayerRegistry::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return zones_.size();
+}
+
+void PlayerRegistry::forEach(const std::function<void(const std::string&, Player&)>& fn) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& zone : zones_) {
+        fn(zone.name, *zone.player);
+    }
+}
+
+void PlayerRegistry::setCachingProfile(const std::string& name) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!CachingProfile::find(name)) {
+        throw std::runtime_error("Unknown caching profile: " + name);
+    }
+    cachingProfile_ = name;
+    for (auto& zone : zones_) {
+        zone.player->setCachingProfile(name);
+    }
+}
+
+} // namespace core
+} // namespace podradio
@@ -1,94 +1,207 @@
 #include "core/PodcastFeed.hpp"
+#include "core/Logger.hpp"
+#include "core/RssStreamParser.hpp"
+#include "core/HttpClient.hpp"
+#include "core/UrlClassifier.hpp"
+#include "core/ThreadPool.hpp"
+#include "core/Metrics.hpp"
 #include <stdexcept>
 #include <sstream>
-#include <iostream>
 #include <vector>
 #include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <condition_variable>
 #include <cpr/cpr.h>
-#include <pugixml.hpp>
-#include <ada.h>
 
 namespace podradio {
 namespace core {
 
-PodcastFeed::PodcastFeed() {
-    // No initialization needed
+namespace {
+
+const size_t kItemChunkSize = 128;
+
+struct FeedMetrics {
+    Histogram& fetchUs = MetricsRegistry::global().histogram("feed.fetch_us");
+    Histogram& parseUs = MetricsRegistry::global().histogram("feed.parse_us");
+    Counter& bytesRead = MetricsRegistry::global().counter("feed.bytes_read");
+    Counter& notModified = MetricsRegistry::global().counter("feed.not_modified");
+    Counter& errors = MetricsRegistry::global().counter("feed.errors");
+};
+
+FeedMetrics& feedMetrics() {
+    static FeedMetrics metrics;
+    return metrics;
 }
 
-std::string PodcastFeed::cleanAndValidateUrl(const std::string& url) const {
-    if (url.empty()) {
-        return "";
-    }
+struct ItemChunk {
+    std::vector<RssItem> items;
+    std::vector<std::string> audioUrls;
+};
 
-    // Trim whitespace
-    std::string cleaned = url;
-    cleaned.erase(0, cleaned.find_first_not_of(" \t\n\r"));
-    cleaned.erase(cleaned.find_last_not_of(" \t\n\r") + 1);
+// Chunks shared with pool helpers. Any thread may claim the next unclaimed
+// chunk, so idle workers (e.g. other refresh lanes) steal from a busy feed
+// and the parsing thread finishes whatever nobody picked up.
+struct ChunkQueue {
+    std::mutex mutex;
+    std::condition_variable idle;
+    std::vector<std::shared_ptr<ItemChunk>> chunks;
+    size_t nextUnclaimed = 0;
+    size_t running = 0;
 
-    if (cleaned.empty()) {
-        return "";
-    }
+    template <typename Extract>
+    bool processOne(Extract extract) {
+        std::shared_ptr<ItemChunk> chunk;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (nextUnclaimed == chunks.size()) {
+                return false;
+            }
+            chunk = chunks[nextUnclaimed++];
+            ++running;
+        }
 
-    // Use ada-url for proper URL parsing and validation
-    auto parsed_url = ada::parse<ada::url>(cleaned);
-    if (!parsed_url) {
-        return "";
-    }
+        chunk->audioUrls.reserve(chunk->items.size());
+        for (const auto& item : chunk->items) {
+            chunk->audioUrls.push_back(extract(item));
+        }
 
-    // Validate scheme
-    if (parsed_url->get_protocol() != "http:" && parsed_url->get_protocol() != "https:") {
-        return "";
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            --running;
+        }
+        idle.notify_all();
+        return true;
     }
+};
 
-    // Check for common audio file extensions or streaming patterns
-    std::string path = std::string(parsed_url->get_pathname());
-    std::string query = std::string(parsed_url->get_search());
-    std::string full_url = parsed_url->get_href();
-    
-    std::vector<std::string> audioExts = {".mp3", ".m4a", ".wav", ".ogg", ".aac", ".mp4"};
-    std::vector<std::string> streamingPatterns = {"podtrac.com", "megaphone.fm", "libsyn.com", "soundcloud.com"};
-    
-    bool isAudioUrl = false;
-    
-    // Check for audio file extensions
-    for (const auto& ext : audioExts) {
-        if (path.find(ext) != std::string::npos || query.find(ext) != std::string::npos) {
-            isAudioUrl = true;
-            break;
+} // namespace
+
+class ItemBatch {
+public:
+    explicit ItemBatch(ThreadPool& pool) : pool_(pool), queue_(std::make_shared<ChunkQueue>()) {}
+
+    void add(RssItem&& item) {
+        if (!current_) {
+            current_ = std::make_shared<ItemChunk>();
+            current_->items.reserve(kItemChunkSize);
+        }
+        current_->items.push_back(std::move(item));
+        if (current_->items.size() == kItemChunkSize) {
+            publish();
+            // Helpers only touch the shared queue, so a parse that throws can leave them behind
+            pool_.submit([queue = queue_] { queue->processOne(&PodcastFeed::extractAudioUrl); });
         }
     }
-    
-    // Check for known streaming patterns
-    if (!isAudioUrl) {
-        for (const auto& pattern : streamingPatterns) {
-            if (full_url.find(pattern) != std::string::npos) {
-                isAudioUrl = true;
-                break;
+
+    // Process the remainder here, wait for helpers, then visit items in feed order
+    template <typename Visit>
+    void finish(Visit visit) {
+        if (current_) {
+            publish();
+        }
+        while (queue_->processOne(&PodcastFeed::extractAudioUrl)) {}
+
+        std::unique_lock<std::mutex> lock(queue_->mutex);
+        queue_->idle.wait(lock, [this] { return queue_->running == 0; });
+        for (const auto& chunk : queue_->chunks) {
+            for (size_t i = 0; i < chunk->items.size(); ++i) {
+                visit(chunk->items[i], chunk->audioUrls[i]);
             }
         }
+        // Helpers still queued behind other work must not pin the items
+        queue_->chunks.clear();
+        queue_->nextUnclaimed = 0;
     }
 
-    return full_url;
+private:
+    void publish() {
+        std::lock_guard<std::mutex> lock(queue_->mutex);
+        queue_->chunks.push_back(std::move(current_));
+        current_.reset();
+    }
+
+    ThreadPool& pool_;
+    std::shared_ptr<ChunkQueue> queue_;
+    std::shared_ptr<ItemChunk> current_;
+};
+
+PodcastFeed::PodcastFeed() {
+    // No initialization needed
 }
 
 void PodcastFeed::loadFromUrl(const std::string& url) {
+    loadFromUrl(url, FeedValidators{});
+}
+
+bool PodcastFeed::loadFromUrl(const std::string& url, const FeedValidators& validators,
+                              const FeedLoadOptions& options) {
     if (url.empty()) {
         throw std::runtime_error("Empty URL provided");
     }
 
+    FeedMetrics& metrics = feedMetrics();
+    // Download and parse overlap, so parse time is accumulated per chunk
+    ScopedTimer fetchTimer(metrics.fetchUs);
+    uint64_t parseUs = 0;
+
     try {
-        // Use cpr for HTTP request with proper headers
-        auto response = cpr::Get(
-            cpr::Url{url},
-            cpr::Header{
-                {"User-Agent", "Mozilla/5.0 (compatible; PodRadio/1.0)"},
-                {"Accept", "application/rss+xml, application/xml, text/xml"},
-                {"Accept-Encoding", "gzip, deflate"}
-            },
-            cpr::Timeout{30000}, // 30 seconds
-            cpr::Redirect{50L},
-            cpr::VerifySsl{true}
-        );
+        cpr::Header header{
+            {"User-Agent", "Mozilla/5.0 (compatible; PodRadio/1.0)"},
+            {"Accept", "application/rss+xml, application/xml, text/xml"},
+            {"Accept-Encoding", "gzip, deflate"}
+        };
+        if (!validators.etag.empty()) {
+            header["If-None-Match"] = validators.etag;
+        }
+        if (!validators.lastModified.empty()) {
+            header["If-Modified-Since"] = validators.lastModified;
+        }
+
+        // Pooled session: feeds on the same host reuse one warm connection
+        auto session = HttpClient::shared().acquire(url);
+        session->SetUrl(cpr::Url{url});
+        session->SetHeader(header);
+        session->SetTimeout(cpr::Timeout{30000}); // 30 seconds
+        session->SetRedirect(cpr::Redirect{50L});
+        session->SetVerifySsl(cpr::VerifySsl{true});
+
+        // Parse the body as it arrives instead of buffering the whole document
+        std::unique_ptr<ItemBatch> batch;
+        if (options.parsePool && options.maxItems == 0) {
+            batch = std::make_unique<ItemBatch>(*options.parsePool);
+        }
+        RssStreamParser parser([this, &options, &batch](RssItem& item) {
+            return addItem(item, options, batch.get());
+        });
+        size_t bytesReceived = 0;
+        auto holder = session->GetCurlHolder();
+        auto response = session->Download(cpr::WriteCallback{[&](std::string data, intptr_t) {
+            if (bytesReceived == 0) {
+                // Headers are complete by the first body chunk. Only a 200
+                // replaces the feed; error pages are never parsed.
+                long code = 0;
+                curl_easy_getinfo(holder->handle, CURLINFO_RESPONSE_CODE, &code);
+                if (code != 200) {
+                    return false;
+                }
+                resetFeed();
+            }
+            bytesReceived += data.size();
+            auto parseStart = std::chrono::steady_clock::now();
+            // Returning false aborts the transfer once the parser has enough
+            bool more = parser.feed(data);
+            parseUs += ScopedTimer::elapsedUs(parseStart);
+            return more;
+        }});
+        metrics.bytesRead.add(bytesReceived);
+
+        // Feed unchanged since the cached copy - skip download and parse
+        if (response.status_code == 304) {
+            metrics.notModified.add();
+            validators_ = validators;
+            return false;
+        }
         
         if (response.status_code != 200) {
             std::stringstream err;
@@ -99,7 +212,12 @@ void PodcastFeed::loadFromUrl(const std::string& url) {
             throw std::runtime_error(err.str());
         }
 
-        if (response.text.empty()) {
+        // A transfer we aborted ourselves is expected; anything else is a real error
+        if (response.error.code != cpr::ErrorCode::OK && !parser.stopped()) {
+            throw std::runtime_error("Failed to fetch podcast feed: " + response.error.message);
+        }
+
+        if (bytesReceived == 0) {
             throw std::runtime_error("Empty response received from feed URL");
         }
 
@@ -111,30 +229,48 @@ void PodcastFeed::loadFromUrl(const std::string& url) {
             if (type.find("xml") == std::string::npos && 
                 type.find("rss") == std::string::npos && 
                 type.find("atom") == std::string::npos) {
-                std::cout << "Warning: Unexpected content type: " << type << std::endl;
+                LOG_WARN << "Unexpected content type: " << type;
             }
         }
 
-        parseFeed(response.text);
+        auto parseStart = std::chrono::steady_clock::now();
+        parser.finish();
+        if (batch) {
+            mergeBatch(*batch);
+        }
+        finishParse(parser);
+        metrics.parseUs.record(parseUs + ScopedTimer::elapsedUs(parseStart));
+
+        validators_ = FeedValidators{};
+        if (auto etag_it = response.header.find("etag"); etag_it != response.header.end()) {
+            validators_.etag = etag_it->second;
+        }
+        if (auto modified_it = response.header.find("last-modified"); modified_it != response.header.end()) {
+            validators_.lastModified = modified_it->second;
+        }
+        return true;
         
     } catch (const std::exception& e) {
-        std::cerr << "Error fetching feed: " << e.what() << std::endl;
+        metrics.errors.add();
+        LOG_ERROR << "Error fetching feed: " << e.what();
         throw;
     }
 }
 
-std::string PodcastFeed::extractAudioUrl(const pugi::xml_node& item) const {
+void PodcastFeed::loadFromString(const std::string& xml, const FeedLoadOptions& options) {
+    parseFeed(xml, options);
+}
+
+std::string PodcastFeed::extractAudioUrl(const RssItem& item) {
     std::string audioUrl;
     
     // First priority: Look for enclosure tag with audio type
-    auto enclosure = item.child("enclosure");
-    if (enclosure) {
-        std::string url = enclosure.attribute("url").value();
-        std::string type = enclosure.attribute("type").value();
+    if (!item.enclosureUrl.empty()) {
+        const std::string& type = item.enclosureType;
         
         // Check if it's an audio type
         if (type.find("audio/") == 0 || type.find("application/octet-stream") == 0) {
-            audioUrl = cleanAndValidateUrl(url);
+            audioUrl = UrlClassifier::clean(item.enclosureUrl);
             if (!audioUrl.empty()) {
                 return audioUrl;
             }
@@ -142,13 +278,11 @@ std::string PodcastFeed::extractAudioUrl(const pugi::xml_node& item) const {
     }
     
     // Second priority: Look for media:content tag with audio URL
-    auto media_content = item.child("media:content");
-    if (media_content) {
-        std::string url = media_content.attribute("url").value();
-        std::string type = media_content.attribute("type").value();
+    if (!item.mediaUrl.empty()) {
+        const std::string& type = item.mediaType;
         
         if (type.find("audio/") == 0 || type.find("application/octet-stream") == 0) {
-            audioUrl = cleanAndValidateUrl(url);
+            audioUrl = UrlClassifier::clean(item.mediaUrl);
             if (!audioUrl.empty()) {
                 return audioUrl;
             }
@@ -156,110 +290,105 @@ std::string PodcastFeed::extractAudioUrl(const pugi::xml_node& item) const {
     }
     
     // Third priority: Look for link tag that might contain audio URL
-    auto link = item.child("link");
-    if (link && link.text()) {
-        std::string linkUrl = link.text().get();
-        if (linkUrl.find("http") == 0) {
-            audioUrl = cleanAndValidateUrl(linkUrl);
-            if (!audioUrl.empty()) {
-                return audioUrl;
-            }
+    if (item.link.find("http") == 0) {
+        audioUrl = UrlClassifier::clean(item.link);
+        if (!audioUrl.empty()) {
+            return audioUrl;
         }
     }
     
     // Fourth priority: Look for audio URL in guid
-    auto guid = item.child("guid");
-    if (guid && guid.text()) {
-        std::string guidStr = guid.text().get();
-        if (guidStr.find("http") == 0) {
-            audioUrl = cleanAndValidateUrl(guidStr);
-            if (!audioUrl.empty()) {
-                return audioUrl;
-            }
+    if (item.guid.find("http") == 0) {
+        audioUrl = UrlClassifier::clean(item.guid);
+        if (!audioUrl.empty()) {
+            return audioUrl;
         }
     }
     
     return "";
 }
 
-void PodcastFeed::parseFeed(const std::string& xml) {
-    pugi::xml_parse_result result = doc_.load_string(xml.c_str());
-    if (!result) {
-        throw std::runtime_error("Failed to parse XML feed: " + std::string(result.description()));
+void PodcastFeed::parseFeed(const std::string& xml, const FeedLoadOptions& options) {
+    ScopedTimer parseTimer(feedMetrics().parseUs);
+    resetFeed();
+
+    std::unique_ptr<ItemBatch> batch;
+    if (options.parsePool && options.maxItems == 0) {
+        batch = std::make_unique<ItemBatch>(*options.parsePool);
     }
+    RssStreamParser parser([this, &options, &batch](RssItem& item) {
+        return addItem(item, options, batch.get());
+    });
+    parser.feed(xml);
+    parser.finish();
+    if (batch) {
+        mergeBatch(*batch);
+    }
+    finishParse(parser);
+}
 
+void PodcastFeed::resetFeed() {
     // Clear existing data
     episodes_.clear();
     title_.clear();
     description_.clear();
     link_.clear();
     language_.clear();
+    reachedKnownGuid_ = false;
+}
 
-    // Find the channel - try both RSS and Atom formats
-    pugi::xml_node channel = doc_.child("rss").child("channel");
-    if (!channel) {
-        channel = doc_.child("feed"); // Try Atom format
-    }
-    
-    if (!channel) {
-        throw std::runtime_error("Invalid podcast feed format: no channel or feed element found");
+bool PodcastFeed::addItem(RssItem& item, const FeedLoadOptions& options, ItemBatch* batch) {
+    // Feeds are newest-first, so everything after a known guid is already cached
+    if (options.isKnownGuid && !item.guid.empty() && options.isKnownGuid(item.guid)) {
+        reachedKnownGuid_ = true;
+        return false;
     }
 
-    // Parse channel metadata
-    if (auto title = channel.child("title")) {
-        title_ = title.text().get();
+    if (batch) {
+        batch->add(std::move(item));
+        return true;
     }
-    
-    if (auto description = channel.child("description")) {
-        description_ = description.text().get();
-    }
-    
-    if (auto link = channel.child("link")) {
-        link_ = link.text().get();
-    }
-    
-    if (auto language = channel.child("language")) {
-        language_ = language.text().get();
+
+    // Extract audio URL
+    std::string audioUrl = extractAudioUrl(item);
+    if (audioUrl.empty()) {
+        return true;
     }
 
-    // Parse episodes (items)
-    int episodes_with_audio = 0;
+    episodes_.add(item.title, item.description, audioUrl, item.pubDate, item.duration, item.guid,
+                  item.descriptionEncoded);
 
-    for (auto item : channel.children("item")) {
-        Episode episode;
-        
-        // Parse episode metadata
-        if (auto title = item.child("title")) {
-            episode.title = title.text().get();
-        }
-        
-        if (auto description = item.child("description")) {
-            episode.description = description.text().get();
-        }
-        
-        if (auto pubDate = item.child("pubDate")) {
-            episode.pubDate = pubDate.text().get();
-        }
-        
-        if (auto duration = item.child("itunes:duration")) {
-            episode.duration = duration.text().get();
-        }
-        
-        if (auto guid = item.child("guid")) {
-            episode.guid = guid.text().get();
-        }
-        
-        // Extract audio URL
-        std::string audioUrl = extractAudioUrl(item);
-        
+    return options.maxItems == 0 || episodes_.size() < options.maxItems;
+}
+
+void PodcastFeed::mergeBatch(ItemBatch& batch) {
+    batch.finish([this](const RssItem& item, const std::string& audioUrl) {
         if (!audioUrl.empty()) {
-            episode.url = audioUrl;
-            episodes_.push_back(episode);
-            episodes_with_audio++;
+            episodes_.add(item.title, item.description, audioUrl, item.pubDate, item.duration, item.guid,
+                          item.descriptionEncoded);
         }
+    });
+}
+
+void PodcastFeed::finishParse(RssStreamParser& parser) {
+    if (parser.hasError()) {
+        throw std::runtime_error("Failed to parse XML feed: " + parser.getError());
     }
 
-    if (episodes_.empty()) {
+    // Find the channel - both RSS and Atom formats are recognized
+    if (!parser.foundChannel()) {
+        throw std::runtime_error("Invalid podcast feed format: no channel or feed element found");
+    }
+
+    // Channel metadata
+    const RssChannel& channel = parser.getChannel();
+    title_ = channel.title;
+    description_ = channel.description;
+    link_ = channel.link;
+    language_ = channel.language;
+
+    // Stopping early at a known guid legitimately yields no new episodes
+    if (episodes_.empty() && !reachedKnownGuid_) {
         throw std::runtime_error("No episodes with valid audio URLs found in feed");
     }
 }
@@ -269,7 +398,7 @@ Episode PodcastFeed::getLatestEpisode() const {
         throw std::runtime_error("No episodes available");
     }
     // The first episode in an RSS feed is typically the latest one
-    return episodes_.front();
+    return episodes_.front().toEpisode();
 }
 
 } // namespace core
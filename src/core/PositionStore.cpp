@@ -0,0 +1,144 @@
+#include "core/PositionStore.hpp"
+#include "core/Logger.hpp"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <vector>
+
+namespace podradio {
+namespace core {
+
+namespace {
+
+const int64_t kMinResumeMs = 10000;        // Less than this heard: start over
+const int64_t kFinishedMarginMs = 30000;   // Within this of the end: treat as finished
+const int64_t kResumeRewindMs = 3000;      // Replay a little for context
+const int64_t kSaveGranularityMs = 1000;   // Smaller moves don't dirty the file
+const size_t kMaxEntries = 1000;
+
+int64_t nowMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
+PositionStore::PositionStore(const std::string& path)
+    : writer_(path, [this] { return serialize(); },
+              std::chrono::seconds(5), std::chrono::seconds(30)) {
+    load();
+}
+
+void PositionStore::update(const std::string& guid, int64_t positionMs, int64_t lengthMs) {
+    if (guid.empty() || positionMs < 0) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    Entry& entry = entries_[guid];
+    bool moved = std::abs(entry.positionMs - positionMs) >= kSaveGranularityMs ||
+                 (lengthMs > 0 && entry.lengthMs != lengthMs);
+    entry.positionMs = positionMs;
+    if (lengthMs > 0) {
+        entry.lengthMs = lengthMs;
+    }
+    if (!moved) {
+        return;
+    }
+
+    entry.updatedAt = nowMs();
+    if (entries_.size() > kMaxEntries) {
+        pruneLocked();
+    }
+    writer_.markDirty();
+}
+
+void PositionStore::markFinished(const std::string& guid) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (entries_.erase(guid) > 0) {
+        writer_.markDirty();
+    }
+}
+
+int64_t PositionStore::getResumePosition(const std::string& guid) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(guid);
+    if (it == entries_.end()) {
+        return 0;
+    }
+
+    const Entry& entry = it->second;
+    if (entry.positionMs < kMinResumeMs) {
+        return 0;
+    }
+    if (entry.lengthMs > 0 && entry.positionMs > entry.lengthMs - kFinishedMarginMs) {
+        return 0;
+    }
+    return entry.positionMs - kResumeRewindMs;
+}
+
+size_t PositionStore::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.size();
+}
+
+void PositionStore::pruneLocked() {
+    // Drop the least recently played tenth in one pass
+    std::vector<std::pair<int64_t, std::string>> byAge;
+    byAge.reserve(entries_.size());
+    for (const auto& [guid, entry] : entries_) {
+        byAge.emplace_back(entry.updatedAt, guid);
+    }
+    size_t drop = entries_.size() - kMaxEntries + kMaxEntries / 10;
+    std::nth_element(byAge.begin(), byAge.begin() + drop, byAge.end());
+    for (size_t i = 0; i < drop; ++i) {
+        entries_.erase(byAge[i].second);
+    }
+}
+
+void PositionStore::load() {
+    std::ifstream file(writer_.getPath());
+    if (!file.is_open()) {
+        return;
+    }
+
+    nlohmann::json j;
+    try {
+        file >> j;
+    } catch (const std::exception& e) {
+        LOG_WARN << "Ignoring corrupt playback positions: " << e.what();
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& item : j.value("positions", nlohmann::json::array())) {
+        std::string guid = item.value("guid", "");
+        if (guid.empty()) {
+            continue;
+        }
+        Entry& entry = entries_[guid];
+        entry.positionMs = item.value("position_ms", int64_t{0});
+        entry.lengthMs = item.value("length_ms", int64_t{0});
+        entry.updatedAt = item.value("updated_at", int64_t{0});
+    }
+}
+
+std::string PositionStore::serialize() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    nlohmann::json j;
+    j["positions"] = nlohmann::json::array();
+    for (const auto& [guid, entry] : entries_) {
+        j["positions"].push_back({
+            {"guid", guid},
+            {"position_ms", entry.positionMs},
+            {"length_ms", entry.lengthMs},
+            {"updated_at", entry.updatedAt}
+        });
+    }
+    return j.dump();
+}
+
+} // namespace core
+} // namespace podradio
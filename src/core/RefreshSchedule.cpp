@@ -0,0 +1,415 @@
+#include "core/RefreshSchedule.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <random>
+#include <unordered_set>
+
+namespace podradio {
+namespace core {
+
+namespace {
+
+// Only the recent past says anything about the current cadence
+const size_t kMaxDatedEpisodes = 24;
+const size_t kMinDatedEpisodes = 3;
+
+// Checks per expected publish interval, so a new episode is picked up
+// within about a quarter of the gap between episodes
+const int64_t kChecksPerPublish = 4;
+
+// Weight of the latest check in the unchanged-rate moving average
+const double kUnchangedSmoothing = 0.2;
+
+const uint32_t kMaxBackoffShift = 20;
+
+void skipSpaces(std::string_view& text) {
+    while (!text.empty() && std::isspace(static_cast<unsigned char>(text.front()))) {
+        text.remove_prefix(1);
+    }
+}
+
+// Reads up to maxDigits decimal digits; returns how many were read
+size_t readNumber(std::string_view& text, int& value, size_t maxDigits) {
+    size_t digits = 0;
+    value = 0;
+    while (digits < maxDigits && digits < text.size() &&
+           std::isdigit(static_cast<unsigned char>(text[digits]))) {
+        value = value * 10 + (text[digits] - '0');
+        digits++;
+    }
+    text.remove_prefix(digits);
+    return digits;
+}
+
+bool consume(std::string_view& text, char c) {
+    if (text.empty() || text.front() != c) return false;
+    text.remove_prefix(1);
+    return true;
+}
+
+int monthFromName(std::string_view name) {
+    static const char* const kMonths[] = {
+        "jan", "feb", "mar", "apr", "may", "jun", "jul", "aug", "sep", "oct", "nov", "dec"
+    };
+    if (name.size() < 3) return 0;
+    for (int month = 0; month < 12; ++month) {
+        bool match = true;
+        for (size_t i = 0; i < 3; ++i) {
+            if (std::tolower(static_cast<unsigned char>(name[i])) != kMonths[month][i]) {
+                match = false;
+                break;
+            }
+        }
+        if (match) return month + 1;
+    }
+    return 0;
+}
+
+// "+hhmm", "-hh:mm", "Z" or a US/UTC zone name, as minutes east of UTC.
+// Unrecognized names are read as UTC; being off by a few hours does not
+// matter at the scale of a publish cadence.
+int zoneOffsetMinutes(std::string_view zone) {
+    if (!zone.empty() && (zone.front() == '+' || zone.front() == '-')) {
+        int sign = zone.front() == '-' ? -1 : 1;
+        zone.remove_prefix(1);
+        int hours = 0;
+        int minutes = 0;
+        if (readNumber(zone, hours, 2) != 2) return 0;
+        consume(zone, ':');
+        readNumber(zone, minutes, 2);
+        return sign * (hours * 60 + minutes);
+    }
+
+    static const std::pair<const char*, int> kZones[] = {
+        {"EST", -5}, {"EDT", -4}, {"CST", -6}, {"CDT", -5},
+        {"MST", -7}, {"MDT", -6}, {"PST", -8}, {"PDT", -7}
+    };
+    for (const auto& [name, hours] : kZones) {
+        if (zone.substr(0, 3) == name) return hours * 60;
+    }
+    return 0;
+}
+
+// Days since 1970-01-01 in the proleptic Gregorian calendar
+int64_t daysFromCivil(int year, int month, int day) {
+    year -= month <= 2;
+    const int64_t era = (year >= 0 ? year : year - 399) / 400;
+    const int64_t yearOfEra = year - era * 400;
+    const int64_t dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    const int64_t dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return era * 146097 + dayOfEra - 719468;
+}
+
+std::optional<RefreshSchedule::Clock::time_point> makeTime(int year, int month, int day,
+                                                           int hour, int minute, int second,
+                                                           int offsetMinutes) {
+    if (month < 1 || month > 12 || day < 1 || day > 31 ||
+        hour > 23 || minute > 59 || second > 60) {
+        return std::nullopt;
+    }
+    int64_t seconds = daysFromCivil(year, month, day) * 86400 +
+                      hour * 3600 + minute * 60 + second - offsetMinutes * 60;
+    return RefreshSchedule::Clock::time_point(std::chrono::seconds(seconds));
+}
+
+// "2024-08-05T09:00:00Z", "2024-08-05 09:00:00+02:00"
+std::optional<RefreshSchedule::Clock::time_point> parseIsoDate(std::string_view text) {
+    int year = 0, month = 0, day = 0, hour = 0, minute = 0, second = 0;
+    if (readNumber(text, year, 4) != 4 || !consume(text, '-') ||
+        readNumber(text, month, 2) != 2 || !consume(text, '-') ||
+        readNumber(text, day, 2) != 2) {
+        return std::nullopt;
+    }
+    if (consume(text, 'T') || consume(text, ' ')) {
+        if (!readNumber(text, hour, 2) || !consume(text, ':') || !readNumber(text, minute, 2)) {
+            return std::nullopt;
+        }
+        if (consume(text, ':')) {
+            readNumber(text, second, 2);
+        }
+        if (consume(text, '.')) {
+            while (!text.empty() && std::isdigit(static_cast<unsigned char>(text.front()))) {
+                text.remove_prefix(1);
+            }
+        }
+    }
+    return makeTime(year, month, day, hour, minute, second, zoneOffsetMinutes(text));
+}
+
+// Publish times of the newest dated episodes, newest first, without duplicates
+std::vector<RefreshSchedule::Clock::time_point> recentPublishTimes(const EpisodeStore& episodes) {
+    std::vector<RefreshSchedule::Clock::time_point> times;
+    for (size_t i = 0; i < episodes.size() && times.size() < kMaxDatedEpisodes; ++i) {
+        if (auto published = RefreshSchedule::parsePubDate(episodes[i].pubDate)) {
+            times.push_back(*published);
+        }
+    }
+    std::sort(times.begin(), times.end(), std::greater<>());
+    times.erase(std::unique(times.begin(), times.end()), times.end());
+    return times;
+}
+
+} // namespace
+
+RefreshSchedule::RefreshSchedule(const RefreshOptions& options)
+    : options_(options) {
+    if (options_.minInterval.count() <= 0) {
+        options_.minInterval = std::chrono::seconds(60);
+    }
+    options_.maxInterval = std::max(options_.maxInterval, options_.minInterval);
+    options_.maxBackoff = std::max(options_.maxBackoff, options_.minInterval);
+}
+
+void RefreshSchedule::sync(const SubscriptionSnapshot& snapshot, Clock::time_point now) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    std::unordered_set<std::string> live;
+    for (const auto& item : snapshot) {
+        if (!item->enabled) continue;
+        live.insert(item->id);
+
+        auto [it, inserted] = feeds_.try_emplace(item->id);
+        FeedState& state = it->second;
+        state.subscription = item;
+        if (!inserted) continue;
+
+        // Feeds known at startup were fetched recently if lastUpdated says
+        // so; subscriptions added while running are checked right away
+        if (synced_) {
+            scheduleLocked(item->id, state, now);
+        } else {
+            state.lastChecked = item->lastUpdated;
+            scheduleLocked(item->id, state, std::min(item->lastUpdated, now) + options_.minInterval);
+        }
+    }
+    synced_ = true;
+
+    // Heap entries of dropped feeds are discarded when they surface
+    for (auto it = feeds_.begin(); it != feeds_.end();) {
+        if (live.count(it->first) == 0) {
+            it = feeds_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+std::vector<SubscriptionSnapshot::Item> RefreshSchedule::takeDue(Clock::time_point now) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    // Everything due goes out in one round; the order decides which feeds
+    // the workers (and each host's lanes) get to first
+    std::priority_queue<std::pair<double, std::string>> byGain;
+    while (!heap_.empty() && heap_.top().due <= now) {
+        Pending pending = heap_.top();
+        heap_.pop();
+
+        auto it = feeds_.find(pending.subscriptionId);
+        if (it == feeds_.end() || it->second.generation != pending.generation || it->second.inFlight) {
+            continue;
+        }
+        it->second.inFlight = true;
+        it->second.generation++;
+        byGain.emplace(freshnessGain(it->second, now), pending.subscriptionId);
+    }
+
+    std::vector<SubscriptionSnapshot::Item> due;
+    due.reserve(byGain.size());
+    while (!byGain.empty()) {
+        due.push_back(feeds_[byGain.top().second].subscription);
+        byGain.pop();
+    }
+    return due;
+}
+
+void RefreshSchedule::recordSuccess(const std::string& subscriptionId, const FeedCacheEntry& entry,
+                                    Clock::time_point now) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = feeds_.find(subscriptionId);
+    if (it == feeds_.end()) return;
+
+    FeedState& state = it->second;
+    std::string newestGuid;
+    if (!entry.episodes.empty()) {
+        EpisodeView front = entry.episodes.front();
+        newestGuid = std::string(front.guid.empty() ? front.url : front.guid);
+    }
+
+    // A 304 and a 200 with the same newest episode both count as unchanged
+    bool changed = !state.observed || newestGuid != state.newestGuid;
+    if (state.observed) {
+        state.unchangedRate = state.unchangedRate * (1.0 - kUnchangedSmoothing) +
+                              (changed ? 0.0 : kUnchangedSmoothing);
+    }
+    if (changed) {
+        auto times = recentPublishTimes(entry.episodes);
+        state.lastPublished = times.empty() ? Clock::time_point{} : times.front();
+        state.publishInterval = estimatePublishInterval(entry.episodes);
+    }
+
+    state.observed = true;
+    state.newestGuid = std::move(newestGuid);
+    state.failures = 0;
+    state.inFlight = false;
+    state.lastChecked = now;
+    scheduleLocked(subscriptionId, state, now + jittered(checkIntervalLocked(state, now)));
+}
+
+void RefreshSchedule::recordFailure(const std::string& subscriptionId, Clock::time_point now) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = feeds_.find(subscriptionId);
+    if (it == feeds_.end()) return;
+
+    FeedState& state = it->second;
+    state.failures++;
+    state.inFlight = false;
+
+    // minInterval, doubling per consecutive failure up to maxBackoff
+    uint32_t shift = std::min(state.failures - 1, kMaxBackoffShift);
+    auto backoff = std::min<std::chrono::seconds>(options_.minInterval * (int64_t{1} << shift),
+                                                  options_.maxBackoff);
+    scheduleLocked(subscriptionId, state, now + jittered(backoff));
+}
+
+RefreshSchedule::Clock::time_point RefreshSchedule::nextDue() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    discardStaleLocked();
+    return heap_.empty() ? Clock::time_point::max() : heap_.top().due;
+}
+
+size_t RefreshSchedule::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return feeds_.size();
+}
+
+std::optional<std::chrono::seconds> RefreshSchedule::getPublishInterval(const std::string& subscriptionId) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = feeds_.find(subscriptionId);
+    if (it == feeds_.end()) return std::nullopt;
+    return it->second.publishInterval;
+}
+
+std::optional<RefreshSchedule::Clock::time_point> RefreshSchedule::getNextCheck(const std::string& subscriptionId) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = feeds_.find(subscriptionId);
+    if (it == feeds_.end() || it->second.inFlight) return std::nullopt;
+    return it->second.nextCheck;
+}
+
+std::optional<RefreshSchedule::Clock::time_point> RefreshSchedule::parsePubDate(std::string_view text) {
+    skipSpaces(text);
+    if (text.size() >= 10 && text[4] == '-') {
+        return parseIsoDate(text);
+    }
+
+    // "Mon, 05 Aug 2024 09:00:00 GMT"; the weekday is optional and
+    // sometimes spelled out in full
+    size_t comma = text.find(',');
+    if (comma != std::string_view::npos && comma <= 9) {
+        text.remove_prefix(comma + 1);
+    }
+    skipSpaces(text);
+
+    int day = 0, year = 0, hour = 0, minute = 0, second = 0;
+    if (!readNumber(text, day, 2)) return std::nullopt;
+    skipSpaces(text);
+
+    size_t nameLength = 0;
+    while (nameLength < text.size() && std::isalpha(static_cast<unsigned char>(text[nameLength]))) {
+        nameLength++;
+    }
+    int month = monthFromName(text.substr(0, nameLength));
+    if (month == 0) return std::nullopt;
+    text.remove_prefix(nameLength);
+    skipSpaces(text);
+
+    size_t yearDigits = readNumber(text, year, 4);
+    if (yearDigits == 2) {
+        year += year < 70 ? 2000 : 1900;
+    } else if (yearDigits != 4) {
+        return std::nullopt;
+    }
+    skipSpaces(text);
+
+    // Time of day is required by RFC 822 but missing from some feeds
+    if (!text.empty() && std::isdigit(static_cast<unsigned char>(text.front()))) {
+        if (!readNumber(text, hour, 2) || !consume(text, ':') || !readNumber(text, minute, 2)) {
+            return std::nullopt;
+        }
+        if (consume(text, ':')) {
+            readNumber(text, second, 2);
+        }
+        skipSpaces(text);
+    }
+    return makeTime(year, month, day, hour, minute, second, zoneOffsetMinutes(text));
+}
+
+std::optional<std::chrono::seconds> RefreshSchedule::estimatePublishInterval(const EpisodeStore& episodes) {
+    auto times = recentPublishTimes(episodes);
+    if (times.size() < kMinDatedEpisodes) {
+        return std::nullopt;
+    }
+
+    // The median shrugs off the odd bonus episode or holiday break
+    std::vector<std::chrono::seconds> gaps;
+    gaps.reserve(times.size() - 1);
+    for (size_t i = 1; i < times.size(); ++i) {
+        gaps.push_back(std::chrono::duration_cast<std::chrono::seconds>(times[i - 1] - times[i]));
+    }
+    std::nth_element(gaps.begin(), gaps.begin() + gaps.size() / 2, gaps.end());
+    return gaps[gaps.size() / 2];
+}
+
+void RefreshSchedule::scheduleLocked(const std::string& subscriptionId, FeedState& state, Clock::time_point due) {
+    state.nextCheck = due;
+    state.generation++;
+    heap_.push(Pending{due, subscriptionId, state.generation});
+}
+
+void RefreshSchedule::discardStaleLocked() const {
+    while (!heap_.empty()) {
+        const Pending& top = heap_.top();
+        auto it = feeds_.find(top.subscriptionId);
+        if (it != feeds_.end() && it->second.generation == top.generation && !it->second.inFlight) {
+            return;
+        }
+        heap_.pop();
+    }
+}
+
+std::chrono::seconds RefreshSchedule::checkIntervalLocked(const FeedState& state, Clock::time_point now) const {
+    std::chrono::seconds cadence = options_.interval;
+    if (state.publishInterval) {
+        // A feed that has gone quiet is checked as if it published at half
+        // the rate of its silence, so abandoned shows fade to maxInterval
+        auto silence = std::chrono::duration_cast<std::chrono::seconds>(now - state.lastPublished);
+        cadence = std::max(*state.publishInterval, silence / 2) / kChecksPerPublish;
+    }
+
+    // Feeds that keep coming back unchanged are stretched by up to half
+    // again, feeds that change on most checks are visited twice as often
+    auto interval = std::chrono::seconds(
+        static_cast<int64_t>(static_cast<double>(cadence.count()) * (0.5 + state.unchangedRate)));
+    return std::clamp(interval, options_.minInterval, options_.maxInterval);
+}
+
+double RefreshSchedule::freshnessGain(const FeedState& state, Clock::time_point now) const {
+    // Probability that at least one episode appeared since the last check,
+    // modelling publishes as a Poisson process at the learned rate
+    auto cadence = state.publishInterval.value_or(options_.interval);
+    double elapsed = std::chrono::duration<double>(now - state.lastChecked).count();
+    double mean = std::max(1.0, static_cast<double>(cadence.count()));
+    return 1.0 - std::exp(-std::max(0.0, elapsed) / mean);
+}
+
+RefreshSchedule::Clock::duration RefreshSchedule::jittered(Clock::duration delay) const {
+    if (options_.jitter <= 0) return delay;
+
+    static thread_local std::mt19937 rng{std::random_device{}()};
+    std::uniform_real_distribution<double> dist(1.0 - options_.jitter, 1.0 + options_.jitter);
+    return std::chrono::duration_cast<Clock::duration>(delay * dist(rng));
+}
+
+} // namespace core
+} // namespace podradio
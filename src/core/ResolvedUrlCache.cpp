@@ -0,0 +1,55 @@
+#include "core/ResolvedUrlCache.hpp"
+
+namespace podradio {
+namespace core {
+
+ResolvedUrlCache::ResolvedUrlCache(std::chrono::seconds ttl, size_t maxEntries)
+    : ttl_(ttl), maxEntries_(maxEntries) {
+}
+
+std::optional<std::string> ResolvedUrlCache::lookup(const std::string& url) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(url);
+    if (it == entries_.end()) {
+        return std::nullopt;
+    }
+
+    if (std::chrono::steady_clock::now() >= it->second.expiresAt) {
+        entries_.erase(it);
+        return std::nullopt;
+    }
+    return it->second.resolvedUrl;
+}
+
+void ResolvedUrlCache::store(const std::string& url, const std::string& resolvedUrl) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto now = std::chrono::steady_clock::now();
+
+    if (entries_.size() >= maxEntries_) {
+        evictExpired(now);
+        if (entries_.size() >= maxEntries_) {
+            // Still full of live entries - drop an arbitrary one
+            entries_.erase(entries_.begin());
+        }
+    }
+
+    entries_[url] = Entry{resolvedUrl, now + ttl_};
+}
+
+void ResolvedUrlCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.clear();
+}
+
+void ResolvedUrlCache::evictExpired(std::chrono::steady_clock::time_point now) {
+    for (auto it = entries_.begin(); it != entries_.end();) {
+        if (now >= it->second.expiresAt) {
+            it = entries_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+} // namespace core
+} // namespace podradio
@@ -0,0 +1,411 @@
+#include "core/RssStreamParser.hpp"
+#include <cstdint>
+#include <cstdlib>
+#include <algorithm>
+
+namespace podradio {
+namespace core {
+
+namespace {
+
+bool isSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+void trim(std::string& s) {
+    size_t start = 0;
+    while (start < s.size() && isSpace(s[start])) start++;
+    size_t end = s.size();
+    while (end > start && isSpace(s[end - 1])) end--;
+    if (start != 0 || end != s.size()) {
+        s = s.substr(start, end - start);
+    }
+}
+
+void appendUtf8(std::string& out, uint32_t cp) {
+    if (cp < 0x80) {
+        out += static_cast<char>(cp);
+    } else if (cp < 0x800) {
+        out += static_cast<char>(0xC0 | (cp >> 6));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    } else if (cp < 0x10000) {
+        out += static_cast<char>(0xE0 | (cp >> 12));
+        out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    } else {
+        out += static_cast<char>(0xF0 | (cp >> 18));
+        out += static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    }
+}
+
+// Append text to out, expanding the predefined XML entities and character references
+void appendDecoded(std::string& out, std::string_view text) {
+    size_t pos = 0;
+    while (pos < text.size()) {
+        size_t amp = text.find('&', pos);
+        if (amp == std::string_view::npos) {
+            out.append(text.substr(pos));
+            return;
+        }
+        out.append(text.substr(pos, amp - pos));
+
+        size_t semi = text.find(';', amp);
+        if (semi == std::string_view::npos || semi - amp > 10) {
+            out += '&';
+            pos = amp + 1;
+            continue;
+        }
+
+        std::string_view entity = text.substr(amp + 1, semi - amp - 1);
+        if (entity == "amp") out += '&';
+        else if (entity == "lt") out += '<';
+        else if (entity == "gt") out += '>';
+        else if (entity == "quot") out += '"';
+        else if (entity == "apos") out += '\'';
+        else if (entity.size() > 1 && entity[0] == '#') {
+            std::string digits(entity.substr(1));
+            int base = 10;
+            if (!digits.empty() && (digits[0] == 'x' || digits[0] == 'X')) {
+                digits.erase(0, 1);
+                base = 16;
+            }
+            char* end = nullptr;
+            unsigned long cp = std::strtoul(digits.c_str(), &end, base);
+            if (!digits.empty() && end && *end == '\0' && cp <= 0x10FFFF) {
+                appendUtf8(out, static_cast<uint32_t>(cp));
+            } else {
+                out.append(text.substr(amp, semi - amp + 1));
+            }
+        } else {
+            // Unknown entity - keep it verbatim
+            out.append(text.substr(amp, semi - amp + 1));
+        }
+        pos = semi + 1;
+    }
+}
+
+std::string attributeValue(std::string_view attributes, std::string_view name) {
+    size_t pos = 0;
+    while (pos < attributes.size()) {
+        while (pos < attributes.size() && isSpace(attributes[pos])) pos++;
+        size_t nameStart = pos;
+        while (pos < attributes.size() && attributes[pos] != '=' && !isSpace(attributes[pos])) pos++;
+        std::string_view attrName = attributes.substr(nameStart, pos - nameStart);
+
+        while (pos < attributes.size() && isSpace(attributes[pos])) pos++;
+        if (pos >= attributes.size() || attributes[pos] != '=') {
+            if (pos == nameStart) pos++;
+            continue;
+        }
+        pos++;
+        while (pos < attributes.size() && isSpace(attributes[pos])) pos++;
+        if (pos >= attributes.size()) break;
+
+        char quote = attributes[pos];
+        if (quote != '"' && quote != '\'') break;
+        size_t valueEnd = attributes.find(quote, pos + 1);
+        if (valueEnd == std::string_view::npos) break;
+
+        if (attrName == name) {
+            std::string value;
+            appendDecoded(value, attributes.substr(pos + 1, valueEnd - pos - 1));
+            return value;
+        }
+        pos = valueEnd + 1;
+    }
+    return "";
+}
+
+} // namespace
+
+void RssItem::clear() {
+    title.clear();
+    description.clear();
+    descriptionEncoded = false;
+    pubDate.clear();
+    duration.clear();
+    guid.clear();
+    link.clear();
+    enclosureUrl.clear();
+    enclosureType.clear();
+    mediaUrl.clear();
+    mediaType.clear();
+}
+
+RssStreamParser::RssStreamParser(ItemHandler onItem)
+    : onItem_(std::move(onItem)), resumeScan_(0), channelDepth_(0), itemDepth_(0),
+      capture_(nullptr), captureDepth_(0), captureRaw_(false), captureLiteral_(false),
+      sawChannel_(false), stopped_(false) {
+}
+
+std::string RssStreamParser::decodeEntities(std::string_view text) {
+    std::string out;
+    out.reserve(text.size());
+    appendDecoded(out, text);
+    return out;
+}
+
+bool RssStreamParser::feed(std::string_view chunk) {
+    if (stopped_) {
+        return false;
+    }
+    pending_.append(chunk.data(), chunk.size());
+    return processPending();
+}
+
+bool RssStreamParser::finish() {
+    if (stopped_) {
+        return !hasError();
+    }
+
+    processPending();
+    if (!hasError() && !stack_.empty()) {
+        fail("Unexpected end of document");
+    }
+    return !hasError();
+}
+
+bool RssStreamParser::processPending() {
+    size_t pos = 0;
+
+    while (!stopped_ && pos < pending_.size()) {
+        if (pending_[pos] != '<') {
+            size_t lt = pending_.find('<', pos);
+            size_t end = lt;
+            if (lt == std::string::npos) {
+                // Hold back a possibly split entity reference until the next chunk
+                end = pending_.size();
+                size_t amp = pending_.rfind('&');
+                if (amp != std::string::npos && amp >= pos && pending_.find(';', amp) == std::string::npos) {
+                    end = amp;
+                }
+                if (end == pos) break;
+            }
+            handleText(std::string_view(pending_).substr(pos, end - pos), false);
+            pos = end;
+            continue;
+        }
+
+        size_t remaining = pending_.size() - pos;
+        if (remaining < 2 || (pending_[pos + 1] == '!' && remaining < 9)) {
+            break;
+        }
+
+        std::string_view rest = std::string_view(pending_).substr(pos);
+        const char* terminator = nullptr;
+        size_t prefixLength = 1;
+        bool isCdata = false;
+
+        if (rest.compare(0, 4, "<!--") == 0) {
+            terminator = "-->";
+            prefixLength = 4;
+        } else if (rest.compare(0, 9, "<![CDATA[") == 0) {
+            terminator = "]]>";
+            prefixLength = 9;
+            isCdata = true;
+        } else if (rest[1] == '?') {
+            terminator = "?>";
+            prefixLength = 2;
+        } else if (rest[1] == '!') {
+            // DOCTYPE and friends; skip an internal subset if present
+            size_t gt = rest.find('>');
+            if (gt == std::string_view::npos) {
+                break;
+            }
+            terminator = rest.substr(0, gt).find('[') != std::string_view::npos ? "]>" : ">";
+            prefixLength = 2;
+        }
+
+        if (terminator) {
+            std::string_view term(terminator);
+            size_t searchFrom = std::max(prefixLength, pos == 0 ? resumeScan_ : 0);
+            size_t close = rest.find(term, searchFrom);
+            if (close == std::string_view::npos) {
+                // Avoid rescanning a large CDATA section on every chunk
+                resumeScan_ = rest.size() >= term.size() ? rest.size() - term.size() + 1 : 0;
+                break;
+            }
+            resumeScan_ = 0;
+
+            if (isCdata) {
+                handleText(rest.substr(prefixLength, close - prefixLength), true);
+            }
+            pos += close + term.size();
+            continue;
+        }
+
+        // Regular start or end tag - find '>' outside quoted attribute values
+        size_t close = std::string_view::npos;
+        char quote = 0;
+        for (size_t i = 1; i < rest.size(); ++i) {
+            char c = rest[i];
+            if (quote) {
+                if (c == quote) quote = 0;
+            } else if (c == '"' || c == '\'') {
+                quote = c;
+            } else if (c == '>') {
+                close = i;
+                break;
+            }
+        }
+        if (close == std::string_view::npos) {
+            break;
+        }
+
+        std::string_view body = rest.substr(1, close - 1);
+        if (!body.empty() && body[0] == '/') {
+            std::string_view name = body.substr(1);
+            while (!name.empty() && isSpace(name.back())) name.remove_suffix(1);
+            closeElement(name);
+        } else {
+            bool selfClosing = !body.empty() && body.back() == '/';
+            if (selfClosing) body.remove_suffix(1);
+
+            size_t nameEnd = 0;
+            while (nameEnd < body.size() && !isSpace(body[nameEnd])) nameEnd++;
+            if (nameEnd == 0) {
+                fail("Invalid start tag");
+                break;
+            }
+            openElement(body.substr(0, nameEnd), body.substr(nameEnd), selfClosing);
+        }
+        pos += close + 1;
+    }
+
+    pending_.erase(0, pos);
+    return !stopped_;
+}
+
+void RssStreamParser::handleText(std::string_view text, bool raw) {
+    if (!capture_ || stack_.size() != captureDepth_) {
+        return;
+    }
+
+    if (!captureRaw_) {
+        if (raw) {
+            capture_->append(text.data(), text.size());
+        } else {
+            appendDecoded(*capture_, text);
+        }
+        return;
+    }
+
+    // Item descriptions are kept escaped and decoded lazily by consumers.
+    // That only works while every '&' in the buffer is an escape, so a CDATA
+    // section containing '&' forces the buffer back to decoded form.
+    bool hasAmp = text.find('&') != std::string_view::npos;
+    if (raw) {
+        if (hasAmp && item_.descriptionEncoded) {
+            *capture_ = decodeEntities(*capture_);
+            item_.descriptionEncoded = false;
+        }
+        if (hasAmp) {
+            captureLiteral_ = true;
+        }
+        capture_->append(text.data(), text.size());
+    } else if (hasAmp && captureLiteral_) {
+        appendDecoded(*capture_, text);
+    } else {
+        if (hasAmp) {
+            item_.descriptionEncoded = true;
+        }
+        capture_->append(text.data(), text.size());
+    }
+}
+
+void RssStreamParser::openElement(std::string_view name, std::string_view attributes, bool selfClosing) {
+    stack_.emplace_back(name);
+    size_t depth = stack_.size();
+
+    auto captureInto = [&](std::string& field) {
+        // Like pugixml's child(), only the first occurrence counts
+        if (field.empty()) {
+            capture_ = &field;
+            captureDepth_ = depth;
+            captureRaw_ = false;
+            captureLiteral_ = false;
+        }
+    };
+
+    if (!sawChannel_ && ((depth == 2 && name == "channel" && stack_[0] == "rss") ||
+                         (depth == 1 && name == "feed"))) {
+        channelDepth_ = depth;
+        sawChannel_ = true;
+    } else if (channelDepth_ && !itemDepth_ && depth == channelDepth_ + 1) {
+        if (name == "item") {
+            itemDepth_ = depth;
+            item_.clear();
+        } else if (name == "title") {
+            captureInto(channel_.title);
+        } else if (name == "description") {
+            captureInto(channel_.description);
+        } else if (name == "link") {
+            captureInto(channel_.link);
+        } else if (name == "language") {
+            captureInto(channel_.language);
+        }
+    } else if (itemDepth_ && depth == itemDepth_ + 1) {
+        if (name == "title") {
+            captureInto(item_.title);
+        } else if (name == "description") {
+            captureInto(item_.description);
+            captureRaw_ = capture_ == &item_.description;
+        } else if (name == "pubDate") {
+            captureInto(item_.pubDate);
+        } else if (name == "itunes:duration") {
+            captureInto(item_.duration);
+        } else if (name == "guid") {
+            captureInto(item_.guid);
+        } else if (name == "link") {
+            captureInto(item_.link);
+        } else if (name == "enclosure" && item_.enclosureUrl.empty()) {
+            item_.enclosureUrl = attributeValue(attributes, "url");
+            item_.enclosureType = attributeValue(attributes, "type");
+        } else if (name == "media:content" && item_.mediaUrl.empty()) {
+            item_.mediaUrl = attributeValue(attributes, "url");
+            item_.mediaType = attributeValue(attributes, "type");
+        }
+    }
+
+    if (selfClosing) {
+        closeElement(name);
+    }
+}
+
+void RssStreamParser::closeElement(std::string_view name) {
+    if (stack_.empty() || stack_.back() != name) {
+        fail("Start-end tags mismatch");
+        return;
+    }
+
+    size_t depth = stack_.size();
+    stack_.pop_back();
+
+    if (capture_ && depth == captureDepth_) {
+        trim(*capture_);
+        capture_ = nullptr;
+        captureDepth_ = 0;
+    }
+
+    if (itemDepth_ && depth == itemDepth_) {
+        itemDepth_ = 0;
+        if (!onItem_(item_)) {
+            stopped_ = true;
+        }
+        item_.clear();
+    } else if (channelDepth_ && depth == channelDepth_) {
+        channelDepth_ = 0;
+    }
+}
+
+void RssStreamParser::fail(const std::string& message) {
+    if (error_.empty()) {
+        error_ = message;
+    }
+    stopped_ = true;
+}
+
+} // namespace core
+} // namespace podradio
@@ -0,0 +1,427 @@
+#include "core/SearchIndex.hpp"
+#include "core/RssStreamParser.hpp"
+#include <algorithm>
+#include <functional>
+#include <mutex>
+#include <unordered_set>
+
+namespace podradio {
+namespace core {
+
+namespace {
+
+const size_t kMinTermLength = 2;
+const size_t kMaxTermLength = 32;
+
+// Show notes can run to many kilobytes of links and sponsor reads; the
+// opening paragraphs carry the searchable part
+const size_t kMaxDescriptionBytes = 2048;
+
+// A one- or two-letter final word would otherwise expand to most of the index
+const size_t kMaxPrefixTerms = 64;
+
+const uint32_t kTitleWeight = 4;
+const uint32_t kDescriptionWeight = 1;
+
+template <typename Fn>
+void forEachWord(std::string_view text, bool markup, Fn&& fn) {
+    std::string word;
+    auto finishWord = [&] {
+        if (word.size() >= kMinTermLength) {
+            fn(word);
+        }
+        word.clear();
+    };
+
+    bool inTag = false;
+    for (char c : text) {
+        unsigned char byte = static_cast<unsigned char>(c);
+        if (markup) {
+            if (inTag) {
+                inTag = c != '>';
+                continue;
+            }
+            if (c == '<') {
+                finishWord();
+                inTag = true;
+                continue;
+            }
+        }
+
+        // Bytes of multi-byte UTF-8 sequences count as letters
+        bool letter = (byte >= 'a' && byte <= 'z') || (byte >= '0' && byte <= '9') || byte >= 0x80;
+        if (byte >= 'A' && byte <= 'Z') {
+            byte = static_cast<unsigned char>(byte - 'A' + 'a');
+            letter = true;
+        }
+        if (letter) {
+            if (word.size() < kMaxTermLength) {
+                word.push_back(static_cast<char>(byte));
+            }
+        } else {
+            finishWord();
+        }
+    }
+    finishWord();
+}
+
+void addWeights(std::unordered_map<std::string, uint32_t>& weights, std::string_view text, bool markup,
+                uint32_t weight) {
+    forEachWord(text, markup, [&weights, weight](const std::string& word) {
+        weights[word] += weight;
+    });
+}
+
+size_t fingerprintOf(const EpisodeView& episode) {
+    return std::hash<std::string_view>()(episode.title) ^ (episode.rawDescription.size() * 0x9e3779b97f4a7c15ULL);
+}
+
+} // namespace
+
+std::vector<std::string> SearchIndex::tokenize(std::string_view text, bool markup) {
+    std::vector<std::string> words;
+    forEachWord(text, markup, [&words](const std::string& word) { words.push_back(word); });
+    return words;
+}
+
+void SearchIndex::syncSubscriptions(const SubscriptionSnapshot& snapshot) {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+
+    std::unordered_set<std::string> present;
+    for (const auto& item : snapshot) {
+        const Subscription& subscription = *item;
+        present.insert(subscription.id);
+
+        auto it = owners_.find(subscription.id);
+        if (it == owners_.end()) {
+            Owner owner;
+            owner.name = subscription.name;
+            owner.description = subscription.description;
+            indexSubscription(subscription.id, owners_.emplace(subscription.id, std::move(owner)).first->second);
+        } else if (it->second.name != subscription.name || it->second.description != subscription.description) {
+            removeDocument(it->second.document);
+            it->second.name = subscription.name;
+            it->second.description = subscription.description;
+            indexSubscription(subscription.id, it->second);
+        }
+    }
+
+    for (auto it = owners_.begin(); it != owners_.end();) {
+        auto current = it++;
+        if (!present.count(current->first)) {
+            removeOwner(current);
+        }
+    }
+}
+
+void SearchIndex::setEpisodes(const std::string& subscriptionId, std::shared_ptr<const FeedCacheEntry> entry) {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    auto it = owners_.find(subscriptionId);
+    if (it != owners_.end()) {
+        replaceEpisodes(it->second, subscriptionId, std::move(entry));
+    }
+}
+
+void SearchIndex::fillEpisodes(const std::string& subscriptionId, std::shared_ptr<const FeedCacheEntry> entry) {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    auto it = owners_.find(subscriptionId);
+    if (it != owners_.end() && !it->second.episodesIndexed) {
+        replaceEpisodes(it->second, subscriptionId, std::move(entry));
+    }
+}
+
+void SearchIndex::replaceEpisodes(Owner& owner, const std::string& subscriptionId,
+                                  std::shared_ptr<const FeedCacheEntry> entry) {
+    owner.episodesIndexed = true;
+
+    // Episodes still in the feed keep their document; only new or edited
+    // ones are tokenized, and those that left the feed are dropped
+    std::unordered_map<std::string, uint32_t> episodes;
+    if (entry) {
+        const EpisodeStore& store = entry->episodes;
+        episodes.reserve(store.size());
+        for (size_t i = 0; i < store.size(); ++i) {
+            EpisodeView episode = store[i];
+            std::string key(episode.guid.empty() ? episode.url : episode.guid);
+            if (key.empty() || episodes.count(key)) {
+                continue;
+            }
+
+            auto existing = owner.episodes.find(key);
+            if (existing != owner.episodes.end()) {
+                Document& document = documents_.at(existing->second);
+                if (document.fingerprint == fingerprintOf(episode)) {
+                    document.episodeIndex = i;
+                    episodes.emplace(key, existing->second);
+                    owner.episodes.erase(existing);
+                    continue;
+                }
+            }
+            episodes.emplace(key, indexEpisode(subscriptionId, episode, i));
+        }
+    }
+
+    for (const auto& [key, document] : owner.episodes) {
+        removeDocument(document);
+    }
+    owner.episodes = std::move(episodes);
+    owner.entry = std::move(entry);
+}
+
+std::vector<std::string> SearchIndex::getUnindexedSubscriptions() const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    std::vector<std::string> ids;
+    for (const auto& [id, owner] : owners_) {
+        if (!owner.episodesIndexed) {
+            ids.push_back(id);
+        }
+    }
+    return ids;
+}
+
+SearchResults SearchIndex::search(const SearchQuery& query) const {
+    SearchResults results;
+    std::vector<std::string> words = tokenize(query.text);
+    if (words.empty()) {
+        return results;
+    }
+
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+
+    // Every word must match. Start from the word with the fewest postings and
+    // probe the others' sorted postings, so common words stay cheap.
+    std::vector<std::vector<uint32_t>> wordTerms;
+    std::vector<size_t> wordPostings;
+    for (size_t i = 0; i < words.size(); ++i) {
+        wordTerms.push_back(termsFor(words[i], i + 1 == words.size()));
+        size_t count = 0;
+        for (uint32_t term : wordTerms.back()) {
+            count += postings_[term].size();
+        }
+        if (count == 0) {
+            return results;
+        }
+        wordPostings.push_back(count);
+    }
+    size_t rarest = std::min_element(wordPostings.begin(), wordPostings.end()) - wordPostings.begin();
+
+    // (document, score) sorted by document, like the postings
+    std::vector<std::pair<uint32_t, uint32_t>> matches;
+    matches.reserve(wordPostings[rarest]);
+    for (uint32_t term : wordTerms[rarest]) {
+        for (const Posting& posting : postings_[term]) {
+            matches.emplace_back(posting.document, posting.weight);
+        }
+    }
+    if (wordTerms[rarest].size() > 1) {
+        // A word counts once per document, at its best weight
+        std::sort(matches.begin(), matches.end());
+        size_t kept = 0;
+        for (size_t i = 0; i < matches.size(); ++i) {
+            if (kept > 0 && matches[kept - 1].first == matches[i].first) {
+                matches[kept - 1].second = std::max(matches[kept - 1].second, matches[i].second);
+            } else {
+                matches[kept++] = matches[i];
+            }
+        }
+        matches.resize(kept);
+    }
+
+    for (size_t i = 0; i < wordTerms.size() && !matches.empty(); ++i) {
+        if (i == rarest) {
+            continue;
+        }
+        // Candidates ascend, so each term's cursor only moves forward
+        std::vector<std::vector<Posting>::const_iterator> cursors;
+        for (uint32_t term : wordTerms[i]) {
+            cursors.push_back(postings_[term].begin());
+        }
+        size_t kept = 0;
+        for (const auto& [document, score] : matches) {
+            uint32_t weight = 0;
+            for (size_t t = 0; t < cursors.size(); ++t) {
+                const auto& postings = postings_[wordTerms[i][t]];
+                cursors[t] = std::lower_bound(cursors[t], postings.end(), document,
+                                              [](const Posting& p, uint32_t id) { return p.document < id; });
+                if (cursors[t] != postings.end() && cursors[t]->document == document) {
+                    weight = std::max(weight, cursors[t]->weight);
+                }
+            }
+            if (weight > 0) {
+                matches[kept++] = {document, score + weight};
+            }
+        }
+        matches.resize(kept);
+    }
+
+    bool episodesOnly = query.scope == SearchScope::Episodes || !query.subscriptionId.empty();
+    struct Ranked {
+        const Document* document;
+        uint32_t id;
+        uint32_t score;
+    };
+    std::vector<Ranked> ranked;
+    ranked.reserve(matches.size());
+    for (const auto& [id, score] : matches) {
+        const Document& document = documents_.at(id);
+        if (document.episode ? query.scope == SearchScope::Podcasts : episodesOnly) {
+            continue;
+        }
+        if (!query.subscriptionId.empty() && document.subscriptionId != query.subscriptionId) {
+            continue;
+        }
+        ranked.push_back({&document, id, score});
+    }
+
+    // Best score first; on ties podcasts before episodes, then newest episodes
+    auto rankBefore = [](const Ranked& a, const Ranked& b) {
+        if (a.score != b.score) return a.score > b.score;
+        if (a.document->episode != b.document->episode) return !a.document->episode;
+        if (a.document->episodeIndex != b.document->episodeIndex) {
+            return a.document->episodeIndex < b.document->episodeIndex;
+        }
+        return a.id < b.id;
+    };
+
+    results.total = ranked.size();
+    if (query.offset >= ranked.size() || query.limit == 0) {
+        return results;
+    }
+    size_t end = std::min(ranked.size(), query.offset + query.limit);
+    std::partial_sort(ranked.begin(), ranked.begin() + end, ranked.end(), rankBefore);
+
+    results.hits.reserve(end - query.offset);
+    for (size_t i = query.offset; i < end; ++i) {
+        const Document& document = *ranked[i].document;
+        SearchHit hit;
+        hit.subscriptionId = document.subscriptionId;
+        hit.score = ranked[i].score;
+        if (document.episode) {
+            hit.entry = owners_.at(document.subscriptionId).entry;
+            hit.episodeIndex = document.episodeIndex;
+        }
+        results.hits.push_back(std::move(hit));
+    }
+    return results;
+}
+
+size_t SearchIndex::getTermCount() const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return terms_.size();
+}
+
+size_t SearchIndex::getDocumentCount() const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return documents_.size();
+}
+
+std::vector<uint32_t> SearchIndex::termsFor(const std::string& word, bool prefix) const {
+    std::vector<uint32_t> terms;
+    if (!prefix) {
+        auto it = terms_.find(word);
+        if (it != terms_.end()) {
+            terms.push_back(it->second);
+        }
+        return terms;
+    }
+
+    for (auto it = terms_.lower_bound(word);
+         it != terms_.end() && it->first.compare(0, word.size(), word) == 0 && terms.size() < kMaxPrefixTerms;
+         ++it) {
+        terms.push_back(it->second);
+    }
+    return terms;
+}
+
+uint32_t SearchIndex::termId(const std::string& term) {
+    auto it = terms_.find(term);
+    if (it != terms_.end()) {
+        return it->second;
+    }
+
+    uint32_t id;
+    if (!freeTerms_.empty()) {
+        id = freeTerms_.back();
+        freeTerms_.pop_back();
+    } else {
+        id = static_cast<uint32_t>(postings_.size());
+        postings_.emplace_back();
+        termEntries_.emplace_back();
+    }
+    termEntries_[id] = terms_.emplace(term, id).first;
+    return id;
+}
+
+uint32_t SearchIndex::addDocument(Document document, const std::unordered_map<std::string, uint32_t>& weights) {
+    uint32_t id = nextDocument_++;
+    document.terms.reserve(weights.size());
+    for (const auto& [term, weight] : weights) {
+        uint32_t term_id = termId(term);
+        postings_[term_id].push_back({id, weight});
+        document.terms.push_back(term_id);
+    }
+    documents_.emplace(id, std::move(document));
+    return id;
+}
+
+void SearchIndex::removeDocument(uint32_t id) {
+    auto it = documents_.find(id);
+    if (it == documents_.end()) {
+        return;
+    }
+
+    for (uint32_t term : it->second.terms) {
+        auto& postings = postings_[term];
+        auto posting = std::lower_bound(postings.begin(), postings.end(), id,
+                                        [](const Posting& p, uint32_t document) { return p.document < document; });
+        if (posting != postings.end() && posting->document == id) {
+            postings.erase(posting);
+        }
+        if (postings.empty()) {
+            std::vector<Posting>().swap(postings);
+            terms_.erase(termEntries_[term]);
+            freeTerms_.push_back(term);
+        }
+    }
+    documents_.erase(it);
+}
+
+void SearchIndex::removeOwner(std::unordered_map<std::string, Owner>::iterator owner) {
+    removeDocument(owner->second.document);
+    for (const auto& [key, document] : owner->second.episodes) {
+        removeDocument(document);
+    }
+    owners_.erase(owner);
+}
+
+void SearchIndex::indexSubscription(const std::string& id, Owner& owner) {
+    std::unordered_map<std::string, uint32_t> weights;
+    addWeights(weights, owner.name, false, kTitleWeight);
+    addWeights(weights, owner.description, true, kDescriptionWeight);
+
+    Document document;
+    document.subscriptionId = id;
+    owner.document = addDocument(std::move(document), weights);
+}
+
+uint32_t SearchIndex::indexEpisode(const std::string& subscriptionId, const EpisodeView& episode, size_t index) {
+    std::unordered_map<std::string, uint32_t> weights;
+    addWeights(weights, episode.title, false, kTitleWeight);
+
+    std::string_view description = episode.rawDescription.substr(0, kMaxDescriptionBytes);
+    if (episode.descriptionEncoded) {
+        addWeights(weights, RssStreamParser::decodeEntities(description), true, kDescriptionWeight);
+    } else {
+        addWeights(weights, description, true, kDescriptionWeight);
+    }
+
+    Document document;
+    document.subscriptionId = subscriptionId;
+    document.episodeIndex = index;
+    document.episode = true;
+    document.fingerprint = fingerprintOf(episode);
+    return addDocument(std::move(document), weights);
+}
+
+} // namespace core
+} // namespace podradio
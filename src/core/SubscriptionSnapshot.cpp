@@ -0,0 +1,44 @@
+#include "core/SubscriptionSnapshot.hpp"
+
+namespace podradio {
+namespace core {
+
+void SubscriptionIndex::add(const Subscription& subscription, size_t position) {
+    byId.emplace(subscription.id, position);
+    byName.emplace(subscription.name, position);
+    byFeedUrl.emplace(subscription.feedUrl, position);
+}
+
+int SubscriptionIndex::find(const std::string& identifier) const {
+    int best = -1;
+    for (const auto* table : {&byName, &byFeedUrl, &byId}) {
+        auto it = table->find(identifier);
+        if (it != table->end() && (best == -1 || static_cast<int>(it->second) < best)) {
+            best = static_cast<int>(it->second);
+        }
+    }
+    return best;
+}
+
+SubscriptionSnapshot::SubscriptionSnapshot()
+    : index_(std::make_shared<const SubscriptionIndex>()) {
+}
+
+SubscriptionSnapshot::SubscriptionSnapshot(std::vector<Item> items)
+    : items_(std::move(items)) {
+    auto index = std::make_shared<SubscriptionIndex>();
+    index->byId.reserve(items_.size());
+    index->byName.reserve(items_.size());
+    index->byFeedUrl.reserve(items_.size());
+    for (size_t i = 0; i < items_.size(); ++i) {
+        index->add(*items_[i], i);
+    }
+    index_ = std::move(index);
+}
+
+SubscriptionSnapshot::SubscriptionSnapshot(std::vector<Item> items, std::shared_ptr<const SubscriptionIndex> index)
+    : items_(std::move(items)), index_(std::move(index)) {
+}
+
+} // namespace core
+} // namespace podradio
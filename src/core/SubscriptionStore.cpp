@@ -0,0 +1,150 @@
+#include "core/SubscriptionStore.hpp"
+#include "core/Logger.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace podradio {
+namespace core {
+
+namespace {
+
+const char kMagic[4] = {'P', 'R', 'S', 'B'};
+const uint32_t kVersion = 1;
+
+// LE helpers; every supported target is little-endian, so these are plain copies
+template <typename T>
+void put(std::string& out, T value) {
+    char bytes[sizeof(T)];
+    std::memcpy(bytes, &value, sizeof(T));
+    out.append(bytes, sizeof(T));
+}
+
+void putString(std::string& out, const std::string& value) {
+    put<uint32_t>(out, static_cast<uint32_t>(value.size()));
+    out.append(value);
+}
+
+// Bounds-checked cursor over the mapped bytes
+struct Reader {
+    const char* data;
+    size_t size;
+    size_t pos = 0;
+
+    template <typename T>
+    bool get(T& value) {
+        if (size - pos < sizeof(T)) {
+            return false;
+        }
+        std::memcpy(&value, data + pos, sizeof(T));
+        pos += sizeof(T);
+        return true;
+    }
+
+    bool getString(std::string& value) {
+        uint32_t length = 0;
+        if (!get(length) || size - pos < length) {
+            return false;
+        }
+        value.assign(data + pos, length);
+        pos += length;
+        return true;
+    }
+};
+
+} // namespace
+
+bool SubscriptionStore::isBinaryPath(const std::string& path) {
+    return std::filesystem::path(path).extension() == ".bin";
+}
+
+std::string SubscriptionStore::encode(const SubscriptionSnapshot& snapshot, int currentIndex) {
+    std::string out(kMagic, sizeof(kMagic));
+    put<uint32_t>(out, kVersion);
+    put<uint32_t>(out, static_cast<uint32_t>(snapshot.size()));
+    put<int32_t>(out, currentIndex);
+
+    for (const auto& sub : snapshot) {
+        put<int64_t>(out, std::chrono::duration_cast<std::chrono::seconds>(sub->lastUpdated.time_since_epoch()).count());
+        put<uint8_t>(out, sub->enabled ? 1 : 0);
+        putString(out, sub->id);
+        putString(out, sub->name);
+        putString(out, sub->feedUrl);
+        putString(out, sub->description);
+    }
+    return out;
+}
+
+bool SubscriptionStore::decode(const char* data, size_t size, std::vector<SubscriptionSnapshot::Item>& items,
+                               int& currentIndex) {
+    if (size < sizeof(kMagic) || std::memcmp(data, kMagic, sizeof(kMagic)) != 0) {
+        return false;
+    }
+    Reader reader{data, size, sizeof(kMagic)};
+
+    uint32_t version = 0;
+    uint32_t count = 0;
+    int32_t index = 0;
+    if (!reader.get(version) || version != kVersion || !reader.get(count) || !reader.get(index)) {
+        return false;
+    }
+
+    std::vector<SubscriptionSnapshot::Item> decoded;
+    // Each record takes at least 25 bytes; don't trust count further than the file can back it
+    decoded.reserve(std::min<size_t>(count, size / 25));
+    for (uint32_t i = 0; i < count; ++i) {
+        Subscription sub;
+        int64_t lastUpdated = 0;
+        uint8_t enabled = 0;
+        if (!reader.get(lastUpdated) || !reader.get(enabled) || !reader.getString(sub.id) ||
+            !reader.getString(sub.name) || !reader.getString(sub.feedUrl) || !reader.getString(sub.description)) {
+            return false;
+        }
+        sub.lastUpdated = std::chrono::system_clock::from_time_t(lastUpdated);
+        sub.enabled = enabled != 0;
+        decoded.push_back(std::make_shared<const Subscription>(std::move(sub)));
+    }
+
+    items = std::move(decoded);
+    currentIndex = index;
+    return true;
+}
+
+bool SubscriptionStore::load(const std::string& path, std::vector<SubscriptionSnapshot::Item>& items,
+                             int& currentIndex) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat info;
+    if (::fstat(fd, &info) != 0 || info.st_size == 0) {
+        ::close(fd);
+        return false;
+    }
+
+    size_t size = static_cast<size_t>(info.st_size);
+    void* mapped = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+        LOG_WARN << "Cannot map " << path << ": " << std::strerror(errno);
+        return false;
+    }
+
+    bool ok = decode(static_cast<const char*>(mapped), size, items, currentIndex);
+    ::munmap(mapped, size);
+    if (!ok) {
+        LOG_WARN << "Ignoring malformed subscription store " << path;
+    }
+    return ok;
+}
+
+} // namespace core
+} // namespace podradio
@@ -0,0 +1,69 @@
+#include "core/ThreadPool.hpp"
+#include "core/Logger.hpp"
+
+namespace podradio {
+namespace core {
+
+ThreadPool::ThreadPool(size_t threadCount) : stopping_(false) {
+    if (threadCount == 0) {
+        threadCount = 1;
+    }
+
+    workers_.reserve(threadCount);
+    for (size_t i = 0; i < threadCount; ++i) {
+        workers_.emplace_back(&ThreadPool::workerLoop, this);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    taskAvailable_.notify_all();
+
+    for (auto& worker : workers_) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+}
+
+void ThreadPool::submit(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        tasks_.push_back(std::move(task));
+    }
+    taskAvailable_.notify_one();
+}
+
+size_t ThreadPool::clearPending() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t dropped = tasks_.size();
+    tasks_.clear();
+    return dropped;
+}
+
+void ThreadPool::workerLoop() {
+    while (true) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            taskAvailable_.wait(lock, [this] { return stopping_ || !tasks_.empty(); });
+            if (stopping_ && tasks_.empty()) {
+                return;
+            }
+            task = std::move(tasks_.front());
+            tasks_.pop_front();
+        }
+
+        try {
+            task();
+        } catch (const std::exception& e) {
+            LOG_ERROR << "Unhandled exception in worker thread: " << e.what();
+        }
+    }
+}
+
+} // namespace core
+} // namespace podradio
@@ -0,0 +1,155 @@
+#include "core/UrlClassifier.hpp"
+#include <ada.h>
+#include <array>
+#include <cstdint>
+#include <cstring>
+
+namespace podradio {
+namespace core {
+
+namespace {
+
+constexpr std::string_view kAudioExtensions[] = {".mp3", ".m4a", ".wav", ".ogg", ".aac", ".mp4"};
+constexpr std::string_view kStreamingHosts[] = {"podtrac.com", "megaphone.fm", "libsyn.com", "soundcloud.com"};
+
+enum CharClass : uint8_t {
+    kHostChar = 1, // Lowercase host characters ada never rewrites
+    kPathChar = 2, // Path, query and fragment characters ada never percent-encodes
+};
+
+constexpr std::array<uint8_t, 256> makeCharTable() {
+    std::array<uint8_t, 256> table{};
+    for (int c = 'a'; c <= 'z'; ++c) table[c] = kHostChar | kPathChar;
+    for (int c = '0'; c <= '9'; ++c) table[c] = kHostChar | kPathChar;
+    for (int c = 'A'; c <= 'Z'; ++c) table[c] = kPathChar;
+    table['-'] = kHostChar | kPathChar;
+    table['.'] = kHostChar | kPathChar;
+    for (char c : std::string_view("_~!$&()*+,;=:@/?#%")) {
+        table[static_cast<unsigned char>(c)] |= kPathChar;
+    }
+    return table;
+}
+
+constexpr std::array<uint8_t, 256> kCharTable = makeCharTable();
+
+bool hasClass(char c, CharClass charClass) {
+    return kCharTable[static_cast<unsigned char>(c)] & charClass;
+}
+
+std::string_view trim(std::string_view url) {
+    size_t start = url.find_first_not_of(" \t\n\r");
+    if (start == std::string_view::npos) {
+        return {};
+    }
+    size_t end = url.find_last_not_of(" \t\n\r");
+    return url.substr(start, end - start + 1);
+}
+
+size_t schemeLength(std::string_view url) {
+    if (url.compare(0, 8, "https://") == 0) return 8;
+    if (url.compare(0, 7, "http://") == 0) return 7;
+    return 0;
+}
+
+} // namespace
+
+std::string UrlClassifier::clean(std::string_view url) {
+    std::string_view trimmed = trim(url);
+    if (trimmed.empty()) {
+        return "";
+    }
+
+    // Feed URLs are nearly always canonical already
+    if (isNormalizedHttpUrl(trimmed)) {
+        return std::string(trimmed);
+    }
+
+    auto parsed = ada::parse<ada::url>(trimmed);
+    if (!parsed) {
+        return "";
+    }
+    if (parsed->get_protocol() != "http:" && parsed->get_protocol() != "https:") {
+        return "";
+    }
+    return parsed->get_href();
+}
+
+bool UrlClassifier::isNormalizedHttpUrl(std::string_view url) {
+    size_t pos = schemeLength(url);
+    if (pos == 0) {
+        return false;
+    }
+
+    // Host: lowercase labels ending at the first '/'. Anything unusual (ports,
+    // credentials, IDNs, numeric hosts ada would rewrite) takes the slow path.
+    size_t hostStart = pos;
+    size_t lastLabel = pos;
+    while (pos < url.size() && hasClass(url[pos], kHostChar)) {
+        if (url[pos] == '.') {
+            if (pos == hostStart || url[pos - 1] == '.') {
+                return false;
+            }
+            lastLabel = pos + 1;
+        }
+        ++pos;
+    }
+    if (pos == hostStart || pos == url.size() || url[pos] != '/') {
+        return false;
+    }
+    std::string_view host = url.substr(hostStart, pos - hostStart);
+    if ((lastLabel < pos && url[lastLabel] >= '0' && url[lastLabel] <= '9') ||
+        host.compare(0, 4, "xn--") == 0 || host.find(".xn--") != std::string_view::npos) {
+        return false;
+    }
+
+    // Path, query and fragment: nothing to encode and no dot segments to resolve
+    for (size_t i = pos; i < url.size(); ++i) {
+        char c = url[i];
+        if (!hasClass(c, kPathChar)) {
+            return false;
+        }
+        if (c == '.' && url[i - 1] == '/') {
+            return false;
+        }
+        if (c == '%' && i + 2 < url.size() && url[i + 1] == '2' && (url[i + 2] | 0x20) == 'e') {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool UrlClassifier::looksLikeAudio(std::string_view url) {
+    // Every pattern contains a '.', so one memchr pass over the dots checks them all
+    size_t scheme = url.find("://");
+    size_t pathStart = url.find('/', scheme == std::string_view::npos ? 0 : scheme + 3);
+    size_t fragment = url.find('#');
+
+    const char* data = url.data();
+    const char* end = data + url.size();
+    for (const char* p = data; p < end;) {
+        const void* found = std::memchr(p, '.', end - p);
+        if (!found) {
+            break;
+        }
+        size_t dot = static_cast<const char*>(found) - data;
+
+        if (dot >= pathStart && dot < fragment) {
+            for (std::string_view ext : kAudioExtensions) {
+                if (url.compare(dot, ext.size(), ext) == 0) {
+                    return true;
+                }
+            }
+        }
+        for (std::string_view host : kStreamingHosts) {
+            size_t offset = host.find('.');
+            if (dot >= offset && url.compare(dot - offset, host.size(), host) == 0) {
+                return true;
+            }
+        }
+        p = data + dot + 1;
+    }
+    return false;
+}
+
+} // namespace core
+} // namespace podradio
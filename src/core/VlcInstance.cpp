@@ -0,0 +1,138 @@
+#include "core/VlcInstance.hpp"
+#include "core/Logger.hpp"
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <stdexcept>
+
+namespace podradio {
+namespace core {
+
+std::vector<std::string> CachingProfile::mediaOptions() const {
+    return {
+        ":network-caching=" + std::to_string(networkCachingMs),
+        ":file-caching=" + std::to_string(fileCachingMs),
+        ":live-caching=" + std::to_string(liveCachingMs),
+        ":network-timeout=" + std::to_string(networkTimeoutMs),
+        ":http-reconnect=true",
+        ":http-user-agent=Mozilla/5.0 (Macintosh; Intel Mac OS X 10_15_7) AppleWebKit/537.36",
+        ":http-referrer="
+    };
+}
+
+const std::vector<CachingProfile>& CachingProfile::all() {
+    static const std::vector<CachingProfile> profiles = {
+        // Matches the long-standing per-media settings
+        {"default", 5000, 2000, 2000, 30000},
+        // Fast start and skip on a good connection
+        {"low-latency", 1000, 300, 300, 10000},
+        // Ride out drop-outs on flaky Wi-Fi or tethered links
+        {"high-loss", 15000, 3000, 5000, 60000}
+    };
+    return profiles;
+}
+
+const CachingProfile& CachingProfile::standard() {
+    return all().front();
+}
+
+const CachingProfile* CachingProfile::find(const std::string& name) {
+    for (const auto& profile : all()) {
+        if (profile.name == name) {
+            return &profile;
+        }
+    }
+    return nullptr;
+}
+
+namespace {
+
+// Lowest libvlc level forwarded to the logger, from PODRADIO_VLC_VERBOSE
+int vlcLogThreshold() {
+    const char* verbose = std::getenv("PODRADIO_VLC_VERBOSE");
+    std::string value = verbose ? verbose : "0";
+    if (value == "2") {
+        return LIBVLC_DEBUG;
+    }
+    if (value == "0") {
+        return LIBVLC_ERROR;
+    }
+    return LIBVLC_WARNING;
+}
+
+LogLevel toLogLevel(int vlcLevel) {
+    switch (vlcLevel) {
+        case LIBVLC_ERROR: return LogLevel::Error;
+        case LIBVLC_WARNING: return LogLevel::Warning;
+        case LIBVLC_NOTICE: return LogLevel::Info;
+        default: return LogLevel::Debug;
+    }
+}
+
+// Runs on libvlc's threads, often many times per second at debug level, so
+// filter before paying for the formatting
+void forwardVlcLog(void* data, int level, const libvlc_log_t*, const char* fmt, va_list args) {
+    int threshold = *static_cast<const int*>(data);
+    LogLevel logLevel = toLogLevel(level);
+    if (level < threshold || !Logger::global().enabled(logLevel)) {
+        return;
+    }
+
+    char buffer[512];
+    int length = std::vsnprintf(buffer, sizeof(buffer), fmt, args);
+    if (length < 0) {
+        return;
+    }
+    Logger::global().log(logLevel, std::string("vlc: ") + buffer);
+}
+
+} // namespace
+
+std::shared_ptr<libvlc_instance_t> VlcInstance::get() {
+    static std::mutex mutex;
+    static std::weak_ptr<libvlc_instance_t> instance;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (auto existing = instance.lock()) {
+        return existing;
+    }
+
+    // Set VLC plugin path for macOS
+    #ifdef __APPLE__
+    setenv("VLC_PLUGIN_PATH", "/Applications/VLC.app/Contents/MacOS/plugins", 1);
+    #endif
+
+    // Audio-only: keep video, subtitle, OSD and scripting subsystems from loading
+    const char* args[] = {
+        "--no-video",
+        "--no-spu",
+        "--no-osd",
+        "--no-lua",
+        "--no-sub-autodetect-file",
+        "--no-snapshot-preview",
+        "--no-media-library",
+        "--ignore-config"
+    };
+
+    libvlc_instance_t* vlc = libvlc_new(sizeof(args) / sizeof(args[0]), args);
+    if (!vlc) {
+        throw std::runtime_error("Failed to initialize VLC");
+    }
+
+    // libvlc's own messages go through the logger instead of straight to
+    // stderr. Only errors by default; PODRADIO_VLC_VERBOSE=1 adds warnings
+    // and 2 adds notices and debug output.
+    static const int threshold = vlcLogThreshold();
+    libvlc_log_set(vlc, forwardVlcLog, const_cast<int*>(&threshold));
+
+    std::shared_ptr<libvlc_instance_t> shared(vlc, [](libvlc_instance_t* released) {
+        libvlc_log_unset(released);
+        libvlc_release(released);
+    });
+    instance = shared;
+    return shared;
+}
+
+} // namespace core
+} // namespace podradio
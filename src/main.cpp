@@ -1,6 +1,12 @@
 #include "core/Player.hpp"
+#include "core/PlayerRegistry.hpp"
 #include "core/FeedManager.hpp"
 #include "core/Subscription.hpp"
+#include "core/FeedRefresher.hpp"
+#include "core/DownloadManager.hpp"
+#include "core/PositionStore.hpp"
+#include "core/Metrics.hpp"
+#include "core/Logger.hpp"
 #ifdef ENABLE_BLUETOOTH
 #include "core/BluetoothServer.hpp"
 #endif
@@ -11,6 +17,7 @@
 #include <iomanip>
 #include <sstream>
 #include <csignal>
+#include <atomic>
 #include <memory>
 
 using namespace podradio::core;
@@ -22,16 +29,19 @@ void printHelp() {
               << "  add <name> <url>     - Add a new podcast subscription\n"
               << "  remove <name>        - Remove a podcast subscription\n"
               << "  list                 - List all subscribed podcasts\n"
+              << "  search <words>       - Find podcasts and cached episodes\n"
               << "  next                 - Select next podcast\n"
               << "  previous             - Select previous podcast\n"
-              << "  current              - Show current podcast\n\n"
+              << "  current              - Show current podcast\n"
+              << "  refresh              - Refresh all podcast feeds now\n\n"
               << "Playback:\n"
               << "  play                 - Play current podcast's latest episode\n"
               << "  play <url>           - Play audio from URL\n"
               << "  pause                - Pause playback\n"
               << "  resume               - Resume playback\n"
               << "  stop                 - Stop playback\n"
-              << "  status               - Show playback status\n\n"
+              << "  status               - Show playback status\n"
+              << "  zones                - List playback zones\n\n"
 #ifdef ENABLE_BLUETOOTH
               << "Bluetooth:\n"
               << "  bluetooth start      - Start Bluetooth server\n"
@@ -40,9 +50,18 @@ void printHelp() {
               << "  bluetooth clients    - List connected Bluetooth clients\n\n"
 #endif
               << "General:\n"
+              << "  metrics              - Show latency histograms (microseconds) and counters\n"
               << "  help                 - Show this help\n"
               << "  quit                 - Exit program\n\n"
               << "Options:\n"
+              << "  --refresh-interval <minutes> - Background refresh interval for feeds without a known publish cadence (default: 30, 0 disables)\n"
+              << "  --fixed-refresh      - Refresh every feed each interval instead of following each feed's cadence\n"
+              << "  --caching <profile>  - Buffering profile: default, low-latency, high-loss\n"
+              << "  --zone <name>[=<device>] - Add a playback zone, optionally on an audio device (repeatable)\n"
+              << "  --store <file>       - Subscription file; a .bin file uses the fast binary store (default: podcasts.json)\n"
+              << "  --downloads <count>  - Keep the newest <count> episodes per podcast offline (default: 0)\n"
+              << "  --download-quota <MB> - Disk space for offline episodes (default: 2048)\n"
+              << "  --download-rate <KB/s> - Bandwidth budget for downloads (default: unlimited)\n"
 #ifdef ENABLE_BLUETOOTH
               << "  --bluetooth          - Start with Bluetooth server enabled\n"
               << "  --bt-port <port>     - Set Bluetooth RFCOMM port (default: 1)\n"
@@ -52,8 +71,8 @@ void printHelp() {
 }
 
 void printPodcastList(const FeedManager& feedManager) {
-    auto subscriptions = feedManager.getSubscriptions();
-    if (subscriptions.empty()) {
+    auto subscriptions = feedManager.getSnapshot();
+    if (subscriptions->empty()) {
         std::cout << "No podcasts subscribed.\n";
         return;
     }
@@ -61,9 +80,10 @@ void printPodcastList(const FeedManager& feedManager) {
     std::cout << "\nSubscribed Podcasts:\n";
     std::cout << std::string(60, '-') << "\n";
     
-    for (size_t i = 0; i < subscriptions.size(); ++i) {
-        const auto& sub = subscriptions[i];
-        std::string marker = (i == feedManager.getCurrentIndex()) ? "* " : "  ";
+    int currentIndex = feedManager.getCurrentIndex();
+    for (size_t i = 0; i < subscriptions->size(); ++i) {
+        const auto& sub = (*subscriptions)[i];
+        std::string marker = (static_cast<int>(i) == currentIndex) ? "* " : "  ";
         std::cout << marker << std::left << std::setw(20) << sub.name 
                   << " | " << sub.feedUrl << "\n";
     }
@@ -71,12 +91,61 @@ void printPodcastList(const FeedManager& feedManager) {
     std::cout << "* = Currently selected\n";
 }
 
+void printSearchResults(const FeedManager& feedManager, const SearchResults& results) {
+    if (results.total == 0) {
+        std::cout << "No matches.\n";
+        return;
+    }
+
+    auto subscriptions = feedManager.getSnapshot();
+    for (const auto& hit : results.hits) {
+        int index = subscriptions->find(hit.subscriptionId);
+        if (index == -1) {
+            continue;
+        }
+        const std::string& podcast = (*subscriptions)[index].name;
+        if (hit.isEpisode()) {
+            EpisodeView episode = hit.entry->episodes[hit.episodeIndex];
+            std::cout << "  " << std::left << std::setw(20) << podcast << " | " << episode.title;
+            if (!episode.pubDate.empty()) {
+                std::cout << " (" << episode.pubDate << ")";
+            }
+            std::cout << "\n";
+        } else {
+            std::cout << "* " << podcast << "\n";
+        }
+    }
+    if (results.hits.size() < results.total) {
+        std::cout << "(" << results.hits.size() << " of " << results.total << " matches)\n";
+    }
+    std::cout << "* = Podcast\n";
+}
+
+// Warm standby players for the neighbouring podcasts so skipping is instant
+void preloadAdjacentEpisodes(Player& player, FeedManager& feedManager) {
+    std::vector<std::string> urls;
+    for (const auto& episode : feedManager.getAdjacentEpisodes()) {
+        urls.push_back(episode.url);
+    }
+    player.preload(urls);
+}
+
 #ifdef ENABLE_BLUETOOTH
-void handleCommand(Player& player, FeedManager& feedManager, std::shared_ptr<BluetoothServer>& bluetoothServer, const std::string& command, const std::vector<std::string>& args = {})
+// Fires on the server's event loop, which must never block on the terminal.
+// Connects and disconnects are already logged by the server itself.
+void logBluetoothEvents(BluetoothServer& server) {
+    server.setOnCommandReceived([](const std::string& address, const std::string& command) {
+        LOG_DEBUG << "Bluetooth command from " << address << ": " << command;
+    });
+}
+
+void handleCommand(PlayerRegistry& players, FeedManager& feedManager, FeedRefresher& feedRefresher, std::shared_ptr<BluetoothServer>& bluetoothServer, const std::string& command, const std::vector<std::string>& args = {})
 #else
-void handleCommand(Player& player, FeedManager& feedManager, const std::string& command, const std::vector<std::string>& args = {})
+void handleCommand(PlayerRegistry& players, FeedManager& feedManager, FeedRefresher& feedRefresher, const std::string& command, const std::vector<std::string>& args = {})
 #endif
 {
+    // Local commands drive the default zone; Bluetooth clients can address any
+    Player& player = players.getDefault();
     try {
         if (command == "add") {
             if (args.size() < 2) {
@@ -96,10 +165,22 @@ void handleCommand(Player& player, FeedManager& feedManager, const std::string&
         else if (command == "list") {
             printPodcastList(feedManager);
         }
+        else if (command == "search") {
+            if (args.empty()) {
+                std::cout << "Usage: search <words>\n";
+                return;
+            }
+            SearchQuery query;
+            for (const auto& word : args) {
+                query.text += (query.text.empty() ? "" : " ") + word;
+            }
+            printSearchResults(feedManager, feedManager.search(query));
+        }
         else if (command == "next") {
             auto podcast = feedManager.nextPodcast();
             if (podcast) {
                 std::cout << "Selected next podcast: " << podcast->name << "\n";
+                preloadAdjacentEpisodes(player, feedManager);
             } else {
                 std::cout << "No podcasts available\n";
             }
@@ -108,6 +189,7 @@ void handleCommand(Player& player, FeedManager& feedManager, const std::string&
             auto podcast = feedManager.previousPodcast();
             if (podcast) {
                 std::cout << "Selected previous podcast: " << podcast->name << "\n";
+                preloadAdjacentEpisodes(player, feedManager);
             } else {
                 std::cout << "No podcasts available\n";
             }
@@ -124,6 +206,11 @@ void handleCommand(Player& player, FeedManager& feedManager, const std::string&
                 std::cout << "No podcast selected\n";
             }
         }
+        else if (command == "refresh") {
+            std::cout << "Refreshing " << feedManager.getSubscriptionCount() << " podcast feeds...\n";
+            size_t refreshed = feedRefresher.refreshAll();
+            std::cout << "Refreshed " << refreshed << " feeds\n";
+        }
         else if (command == "play") {
             if (!args.empty()) {
                 // Play from URL
@@ -140,7 +227,8 @@ void handleCommand(Player& player, FeedManager& feedManager, const std::string&
                 auto episode = feedManager.getLatestEpisode(*podcast);
                 if (episode) {
                     std::cout << "Playing: " << episode->title << "\n";
-                    player.play(episode->url);
+                    player.play(*episode);
+                    preloadAdjacentEpisodes(player, feedManager);
                 } else {
                     std::cout << "Could not load episodes from " << podcast->name << "\n";
                 }
@@ -167,6 +255,19 @@ void handleCommand(Player& player, FeedManager& feedManager, const std::string&
                 std::cout << "Current podcast: " << podcast->name << "\n";
             }
         }
+        else if (command == "zones") {
+            std::string defaultZone = players.getDefaultName();
+            players.forEach([&defaultZone](const std::string& zone, Player& zonePlayer) {
+                std::string marker = zone == defaultZone ? "* " : "  ";
+                const std::string& device = zonePlayer.getAudioDevice();
+                std::cout << marker << std::left << std::setw(20) << zone
+                          << " | " << std::setw(10) << zonePlayer.getStatus().state
+                          << " | " << (device.empty() ? "default output" : device) << "\n";
+            });
+        }
+        else if (command == "metrics") {
+            std::cout << MetricsRegistry::global().format();
+        }
 #ifdef ENABLE_BLUETOOTH
         else if (command == "bluetooth") {
             if (args.empty()) {
@@ -177,16 +278,8 @@ void handleCommand(Player& player, FeedManager& feedManager, const std::string&
             std::string btCommand = args[0];
             if (btCommand == "start") {
                 if (!bluetoothServer) {
-                    bluetoothServer = std::make_shared<BluetoothServer>(feedManager, player);
-                    bluetoothServer->setOnClientConnected([](const std::string& address) {
-                        std::cout << "Bluetooth client connected: " << address << std::endl;
-                    });
-                    bluetoothServer->setOnClientDisconnected([](const std::string& address) {
-                        std::cout << "Bluetooth client disconnected: " << address << std::endl;
-                    });
-                    bluetoothServer->setOnCommandReceived([](const std::string& address, const std::string& command) {
-                        std::cout << "Bluetooth command from " << address << ": " << command << std::endl;
-                    });
+                    bluetoothServer = std::make_shared<BluetoothServer>(feedManager, players);
+                    logBluetoothEvents(*bluetoothServer);
                 }
                 
                 if (bluetoothServer->start()) {
@@ -256,9 +349,15 @@ std::vector<std::string> parseArguments(const std::string& input) {
     return args;
 }
 
-// Global variables for signal handling
+// Global variables for signal handling. The server is owned by main and
+// only borrowed here, so it never outlives the players and feed manager.
 #ifdef ENABLE_BLUETOOTH
-std::shared_ptr<BluetoothServer> g_bluetoothServer;
+std::atomic<BluetoothServer*> g_bluetoothServer{nullptr};
+
+// Unhooks the signal handler before the server it points at is destroyed
+struct SignalTargetReset {
+    ~SignalTargetReset() { g_bluetoothServer = nullptr; }
+};
 #endif
 bool g_running = true;
 
@@ -266,8 +365,8 @@ void signalHandler(int signal) {
     std::cout << "\nReceived signal " << signal << ", shutting down...\n";
     g_running = false;
 #ifdef ENABLE_BLUETOOTH
-    if (g_bluetoothServer) {
-        g_bluetoothServer->stop();
+    if (BluetoothServer* server = g_bluetoothServer.load()) {
+        server->stop();
     }
 #endif
 }
@@ -278,14 +377,16 @@ int main(int argc, char* argv[]) {
     signal(SIGTERM, signalHandler);
     
     try {
-        Player player;
-        FeedManager feedManager;
-#ifdef ENABLE_BLUETOOTH
-        std::shared_ptr<BluetoothServer> bluetoothServer;
-#endif
+        PlayerRegistry players;
+        std::string storageFile = "podcasts.json";
+        RefreshOptions refreshOptions;
+        DownloadOptions downloadOptions;
+        downloadOptions.episodesPerSubscription = 0;
+        std::unique_ptr<DownloadManager> downloads;
         
         // Command line argument parsing
         bool enableBluetooth = false;
+        int refreshIntervalMinutes = 30;
 #ifdef ENABLE_BLUETOOTH
         int bluetoothPort = 1;
 #endif
@@ -303,30 +404,91 @@ int main(int argc, char* argv[]) {
             if (arg == "--help") {
                 printHelp();
                 return 0;
+            } else if (arg == "--refresh-interval" && i + 1 < argc) {
+                refreshIntervalMinutes = std::stoi(argv[++i]);
+            } else if (arg == "--fixed-refresh") {
+                refreshOptions.adaptive = false;
+            } else if (arg == "--caching" && i + 1 < argc) {
+                players.setCachingProfile(argv[++i]);
+            } else if (arg == "--zone" && i + 1 < argc) {
+                std::string zone = argv[++i];
+                size_t separator = zone.find('=');
+                if (separator == std::string::npos) {
+                    players.add(zone);
+                } else {
+                    players.add(zone.substr(0, separator), zone.substr(separator + 1));
+                }
+            } else if (arg == "--store" && i + 1 < argc) {
+                storageFile = argv[++i];
+            } else if (arg == "--downloads" && i + 1 < argc) {
+                downloadOptions.episodesPerSubscription = std::stoul(argv[++i]);
+            } else if (arg == "--download-quota" && i + 1 < argc) {
+                downloadOptions.diskQuotaBytes = std::stoull(argv[++i]) * 1024 * 1024;
+            } else if (arg == "--download-rate" && i + 1 < argc) {
+                downloadOptions.bandwidthBytesPerSecond = std::stoll(argv[++i]) * 1024;
             } else {
                 commands.push_back(arg);
             }
         }
         
-        // Start Bluetooth server if requested
+        FeedManager feedManager(storageFile);
+        Player& player = players.getDefault();
+
+        if (refreshIntervalMinutes > 0) {
+            refreshOptions.interval = std::chrono::minutes(refreshIntervalMinutes);
+        }
+        FeedRefresher feedRefresher(feedManager, refreshOptions);
+
+        // Episodes resume where they were left off, in whichever zone
+        auto positions = std::make_shared<PositionStore>();
+        players.forEach([&positions](const std::string&, Player& zonePlayer) {
+            zonePlayer.setPositionStore(positions);
+        });
+
+        // Offline copies of the newest episodes; play() uses them when present
+        if (downloadOptions.episodesPerSubscription > 0) {
+            downloads = std::make_unique<DownloadManager>(downloadOptions);
+            players.forEach([&downloads](const std::string&, Player& zonePlayer) {
+                zonePlayer.setLocalMediaLookup([&downloads](const std::string& url) {
+                    return downloads->localPathFor(url);
+                });
+            });
+        }
+
+        // Pre-resolve redirect chains for each feed's latest episode. Zones
+        // share the redirect cache, so resolving through one covers them all.
+        feedRefresher.setOnFeedRefreshed([&player, &downloads](const Subscription&, const FeedCacheEntry& entry) {
+            if (!entry.episodes.empty()) {
+                player.prefetchMediaUrl(std::string(entry.episodes.front().url));
+            }
+            if (downloads) {
+                downloads->enqueueLatest(entry.episodes);
+            }
+        });
+
+        // Long-running modes keep the feed cache warm in the background
+        auto startBackgroundRefresh = [&]() {
+            if (refreshIntervalMinutes > 0 && !feedRefresher.isRunning()) {
+                feedManager.setFreshnessWindow(refreshOptions.interval + refreshOptions.interval / 2);
+                feedRefresher.start();
+            }
+        };
+        
+        // Start Bluetooth server if requested. Declared after the feed manager
+        // and players it refers to, so it is destroyed before them.
 #ifdef ENABLE_BLUETOOTH
+        std::shared_ptr<BluetoothServer> bluetoothServer;
+        SignalTargetReset signalTargetReset;
         if (enableBluetooth) {
-            bluetoothServer = std::make_shared<BluetoothServer>(feedManager, player, bluetoothPort);
-            g_bluetoothServer = bluetoothServer;
+            bluetoothServer = std::make_shared<BluetoothServer>(feedManager, players, bluetoothPort);
+            g_bluetoothServer = bluetoothServer.get();
             
-            // Set up event handlers
-            bluetoothServer->setOnClientConnected([](const std::string& address) {
-                std::cout << "Bluetooth client connected: " << address << std::endl;
-            });
-            bluetoothServer->setOnClientDisconnected([](const std::string& address) {
-                std::cout << "Bluetooth client disconnected: " << address << std::endl;
-            });
-            bluetoothServer->setOnCommandReceived([](const std::string& address, const std::string& command) {
-                std::cout << "Bluetooth command from " << address << ": " << command << std::endl;
-            });
+            logBluetoothEvents(*bluetoothServer);
             
             if (bluetoothServer->start()) {
                 std::cout << "Bluetooth server started on port " << bluetoothPort << std::endl;
+                // Accept connections right away; libvlc loads its plugins meanwhile
+                players.forEach([](const std::string&, Player& zonePlayer) { zonePlayer.warmUp(); });
             } else {
                 std::cerr << "Failed to start Bluetooth server" << std::endl;
                 return 1;
@@ -348,9 +510,9 @@ int main(int argc, char* argv[]) {
             
             try {
 #ifdef ENABLE_BLUETOOTH
-                handleCommand(player, feedManager, bluetoothServer, command, args);
+                handleCommand(players, feedManager, feedRefresher, bluetoothServer, command, args);
 #else
-                handleCommand(player, feedManager, command, args);
+                handleCommand(players, feedManager, feedRefresher, command, args);
 #endif
                 
                 // For play commands, keep the program running until interrupted
@@ -368,6 +530,7 @@ int main(int argc, char* argv[]) {
             
             // If Bluetooth is enabled, keep running
             if (enableBluetooth) {
+                startBackgroundRefresh();
                 std::cout << "Bluetooth server running. Press Ctrl+C to stop.\n";
                 while (g_running) {
                     std::this_thread::sleep_for(std::chrono::milliseconds(100));
@@ -378,6 +541,8 @@ int main(int argc, char* argv[]) {
         }
 
         // Interactive mode
+        players.forEach([](const std::string&, Player& zonePlayer) { zonePlayer.warmUp(); });
+        startBackgroundRefresh();
         std::cout << "Welcome to PodRadio!\n";
 #ifdef ENABLE_BLUETOOTH
         if (enableBluetooth) {
@@ -389,6 +554,8 @@ int main(int argc, char* argv[]) {
         std::string input;
 
         while (g_running) {
+            // Let log lines from the last command land before the prompt
+            Logger::global().flush();
             std::cout << "\nEnter command: ";
             std::getline(std::cin, input);
 
@@ -405,9 +572,9 @@ int main(int argc, char* argv[]) {
                         std::string command = parsedArgs[0];
                         std::vector<std::string> args(parsedArgs.begin() + 1, parsedArgs.end());
 #ifdef ENABLE_BLUETOOTH
-                        handleCommand(player, feedManager, bluetoothServer, command, args);
+                        handleCommand(players, feedManager, feedRefresher, bluetoothServer, command, args);
 #else
-                        handleCommand(player, feedManager, command, args);
+                        handleCommand(players, feedManager, feedRefresher, command, args);
 #endif
                     }
                 }
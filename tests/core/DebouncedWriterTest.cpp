@@ -0,0 +1,89 @@
+#include "core/DebouncedWriter.hpp"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+using namespace podradio::core;
+
+class DebouncedWriterTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        path_ = (std::filesystem::temp_directory_path() / "podradio_debounced_writer_test.json").string();
+        std::filesystem::remove(path_);
+    }
+
+    void TearDown() override {
+        std::filesystem::remove(path_);
+    }
+
+    std::string readFile() const {
+        std::ifstream file(path_);
+        std::stringstream content;
+        content << file.rdbuf();
+        return content.str();
+    }
+
+    std::string path_;
+};
+
+TEST_F(DebouncedWriterTest, CoalescesBurstIntoOneWrite) {
+    std::atomic<int> writes{0};
+    std::atomic<int> value{0};
+    DebouncedWriter writer(path_, [&] {
+        ++writes;
+        return std::to_string(value.load());
+    }, std::chrono::milliseconds(50));
+
+    for (int i = 1; i <= 10; ++i) {
+        value = i;
+        writer.markDirty();
+    }
+    EXPECT_EQ(writes, 0);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    EXPECT_EQ(writes, 1);
+    EXPECT_FALSE(writer.isDirty());
+    EXPECT_EQ(readFile(), "10");
+}
+
+TEST_F(DebouncedWriterTest, FlushWritesImmediately) {
+    DebouncedWriter writer(path_, [] { return std::string("now"); }, std::chrono::seconds(60));
+    writer.markDirty();
+    writer.flush();
+    EXPECT_EQ(readFile(), "now");
+    EXPECT_FALSE(std::filesystem::exists(path_ + ".tmp"));
+}
+
+TEST_F(DebouncedWriterTest, DestructorWritesPendingChange) {
+    {
+        DebouncedWriter writer(path_, [] { return std::string("final"); }, std::chrono::seconds(60));
+        writer.markDirty();
+    }
+    EXPECT_EQ(readFile(), "final");
+}
+
+TEST_F(DebouncedWriterTest, CleanWriterDoesNotTouchFile) {
+    {
+        DebouncedWriter writer(path_, [] { return std::string("unused"); });
+    }
+    EXPECT_FALSE(std::filesystem::exists(path_));
+}
+
+TEST_F(DebouncedWriterTest, FailedWriteStaysPending) {
+    std::string directory = (std::filesystem::temp_directory_path() / "podradio_debounced_writer_missing").string();
+    std::filesystem::remove_all(directory);
+    std::string path = directory + "/state.json";
+
+    DebouncedWriter writer(path, [] { return std::string("kept"); }, std::chrono::seconds(60));
+    writer.markDirty();
+    writer.flush();
+    EXPECT_TRUE(writer.isDirty());
+
+    std::filesystem::create_directories(directory);
+    writer.flush();
+    EXPECT_FALSE(writer.isDirty());
+    EXPECT_TRUE(std::filesystem::exists(path));
+    std::filesystem::remove_all(directory);
+}
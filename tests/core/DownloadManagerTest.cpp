@@ -0,0 +1,68 @@
+#include "core/DownloadManager.hpp"
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <nlohmann/json.hpp>
+
+using namespace podradio::core;
+
+class DownloadManagerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        dir_ = std::filesystem::temp_directory_path() / "podradio_download_manager_test";
+        std::filesystem::remove_all(dir_);
+        std::filesystem::create_directories(dir_);
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(dir_);
+    }
+
+    void writeFile(const std::string& name, size_t bytes) {
+        std::ofstream(dir_ / name) << std::string(bytes, 'x');
+    }
+
+    void writeIndex(const nlohmann::json& episodes) {
+        std::ofstream(dir_ / "index.json") << nlohmann::json{{"episodes", episodes}}.dump();
+    }
+
+    DownloadOptions options(uint64_t quota) const {
+        DownloadOptions options;
+        options.directory = dir_.string();
+        options.diskQuotaBytes = quota;
+        return options;
+    }
+
+    std::filesystem::path dir_;
+};
+
+TEST_F(DownloadManagerTest, ServesCompletedDownloadsFromIndex) {
+    writeFile("a.mp3", 10);
+    writeFile("b.mp3.part", 4);
+    writeIndex({
+        {{"url", "https://example.com/a.mp3"}, {"file", "a.mp3"}, {"complete", true}, {"lastUsed", 1}},
+        {{"url", "https://example.com/b.mp3"}, {"file", "b.mp3"}, {"complete", false}},
+        {{"url", "https://example.com/gone.mp3"}, {"file", "gone.mp3"}, {"complete", true}}
+    });
+
+    DownloadManager downloads(options(1000));
+    EXPECT_EQ(downloads.localPathFor("https://example.com/a.mp3"), (dir_ / "a.mp3").string());
+    EXPECT_EQ(downloads.localPathFor("https://example.com/b.mp3"), ""); // Still partial
+    EXPECT_EQ(downloads.localPathFor("https://example.com/gone.mp3"), "");
+    EXPECT_EQ(downloads.getStoredBytes(), 10u);
+}
+
+TEST_F(DownloadManagerTest, EvictsLeastRecentlyUsedOverQuota) {
+    writeFile("old.mp3", 10);
+    writeFile("new.mp3", 10);
+    writeIndex({
+        {{"url", "https://example.com/old.mp3"}, {"file", "old.mp3"}, {"complete", true}, {"lastUsed", 100}},
+        {{"url", "https://example.com/new.mp3"}, {"file", "new.mp3"}, {"complete", true}, {"lastUsed", 200}}
+    });
+
+    DownloadManager downloads(options(15));
+    EXPECT_EQ(downloads.localPathFor("https://example.com/old.mp3"), "");
+    EXPECT_NE(downloads.localPathFor("https://example.com/new.mp3"), "");
+    EXPECT_FALSE(std::filesystem::exists(dir_ / "old.mp3"));
+    EXPECT_EQ(downloads.getStoredBytes(), 10u);
+}
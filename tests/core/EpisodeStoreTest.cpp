@@ -0,0 +1,63 @@
+#include "core/EpisodeStore.hpp"
+#include <gtest/gtest.h>
+#include <string>
+
+using namespace podradio::core;
+
+TEST(EpisodeStoreTest, StoresEpisodesInOneArena) {
+    EpisodeStore store;
+    store.add("First", "One", "https://example.com/1.mp3", "Mon", "10:00", "g1");
+    store.add("Second", "Two &amp; more", "https://example.com/2.mp3", "Tue", "", "g2", true);
+
+    ASSERT_EQ(store.size(), 2u);
+    EXPECT_EQ(store.front().title, "First");
+    EXPECT_EQ(store[1].url, "https://example.com/2.mp3");
+    EXPECT_EQ(store[1].rawDescription, "Two &amp; more");
+    EXPECT_EQ(store[1].description(), "Two & more");
+    EXPECT_EQ(store[0].description(), "One");
+    EXPECT_EQ(store.findGuid("g2"), 1);
+    EXPECT_EQ(store.findGuid("missing"), -1);
+    EXPECT_THROW(store[2], std::out_of_range);
+}
+
+TEST(EpisodeStoreTest, ToEpisodeMaterializesOwningCopy) {
+    Episode episode;
+    {
+        EpisodeStore store;
+        store.add("Title", "Desc &lt;b&gt;", "https://example.com/a.mp3", "Wed", "5:00", "guid", true);
+        episode = store.front().toEpisode();
+    }
+    EXPECT_EQ(episode.title, "Title");
+    EXPECT_EQ(episode.description, "Desc <b>");
+    EXPECT_EQ(episode.guid, "guid");
+}
+
+TEST(EpisodeStoreTest, CopiesBetweenStores) {
+    EpisodeStore source;
+    source.add("A", "x &amp; y", "https://example.com/a.mp3", "", "", "a", true);
+
+    EpisodeStore target;
+    target.add(source.front());
+    EXPECT_EQ(target.front().title, "A");
+    EXPECT_TRUE(target.front().descriptionEncoded);
+    EXPECT_EQ(target.front().description(), "x & y");
+}
+
+TEST(EpisodeStoreTest, FindsGuidsAcrossTableGrowth) {
+    EpisodeStore store;
+    for (int i = 0; i < 1000; ++i) {
+        store.add("Episode", "", "https://example.com/" + std::to_string(i) + ".mp3", "", "",
+                  "guid-" + std::to_string(i % 700));
+    }
+
+    for (int i = 0; i < 700; ++i) {
+        ASSERT_EQ(store.findGuid("guid-" + std::to_string(i)), i);
+    }
+    EXPECT_EQ(store.findGuid("guid-700"), -1);
+
+    store.clear();
+    EXPECT_EQ(store.findGuid("guid-1"), -1);
+    store.reserve(10, 100);
+    store.add("Again", "", "https://example.com/a.mp3", "", "", "guid-1");
+    EXPECT_EQ(store.findGuid("guid-1"), 0);
+}
@@ -0,0 +1,106 @@
+#include "core/FeedCache.hpp"
+#include <gtest/gtest.h>
+#include <filesystem>
+
+using namespace podradio::core;
+
+class FeedCacheTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        directory_ = (std::filesystem::temp_directory_path() / "podradio_feed_cache_test").string();
+        std::filesystem::remove_all(directory_);
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(directory_);
+    }
+
+    std::string directory_;
+};
+
+TEST_F(FeedCacheTest, MissingEntry) {
+    FeedCache cache(directory_);
+    EXPECT_EQ(cache.get("unknown"), nullptr);
+}
+
+TEST_F(FeedCacheTest, PersistsAcrossInstances) {
+    FeedCacheEntry entry;
+    entry.etag = "\"abc123\"";
+    entry.lastModified = "Wed, 01 May 2024 10:00:00 GMT";
+    entry.fetchedAt = std::chrono::system_clock::from_time_t(1714557600);
+
+    Episode episode;
+    episode.title = "Episode 1";
+    episode.url = "https://example.com/ep1.mp3";
+    episode.guid = "ep-1";
+    entry.episodes.add(episode);
+
+    {
+        FeedCache cache(directory_);
+        cache.put("42", entry);
+    }
+
+    FeedCache reloaded(directory_);
+    auto loaded = reloaded.get("42");
+    ASSERT_NE(loaded, nullptr);
+    EXPECT_EQ(loaded->etag, entry.etag);
+    EXPECT_EQ(loaded->lastModified, entry.lastModified);
+    EXPECT_EQ(loaded->fetchedAt, entry.fetchedAt);
+    ASSERT_EQ(loaded->episodes.size(), 1u);
+    EXPECT_EQ(loaded->episodes.front().url, episode.url);
+    EXPECT_EQ(loaded->episodes.front().guid, episode.guid);
+}
+
+TEST_F(FeedCacheTest, PersistsTruncatedFlag) {
+    FeedCacheEntry entry;
+    entry.truncated = true;
+    {
+        FeedCache cache(directory_);
+        cache.put("9", entry);
+    }
+
+    FeedCache reloaded(directory_);
+    auto loaded = reloaded.get("9");
+    ASSERT_NE(loaded, nullptr);
+    EXPECT_TRUE(loaded->truncated);
+}
+
+TEST_F(FeedCacheTest, RemoveDeletesEntry) {
+    FeedCache cache(directory_);
+    FeedCacheEntry entry;
+    entry.etag = "\"v1\"";
+    cache.put("7", entry);
+    cache.remove("7");
+
+    FeedCache reloaded(directory_);
+    EXPECT_EQ(reloaded.get("7"), nullptr);
+}
+
+TEST_F(FeedCacheTest, TouchUpdatesCheckTimeWithoutRewriting) {
+    auto fetched = std::chrono::system_clock::from_time_t(1714557600);
+    FeedCacheEntry entry;
+    entry.etag = "\"v1\"";
+    entry.fetchedAt = fetched;
+
+    auto path = std::filesystem::path(directory_) / "5.json";
+    {
+        FeedCache cache(directory_);
+        auto stored = cache.put("5", entry);
+        EXPECT_EQ(cache.getCheckedAt("5"), fetched);
+
+        auto written = std::filesystem::last_write_time(path);
+        std::filesystem::last_write_time(path, written - std::chrono::hours(1));
+        auto before = std::filesystem::last_write_time(path);
+
+        cache.touch("5", fetched + std::chrono::hours(2));
+        EXPECT_EQ(cache.getCheckedAt("5"), fetched + std::chrono::hours(2));
+        EXPECT_EQ(cache.get("5"), stored);
+        EXPECT_EQ(std::filesystem::last_write_time(path), before);
+    }
+
+    // Only the body's own fetch time survives a restart
+    FeedCache reloaded(directory_);
+    EXPECT_EQ(reloaded.getCheckedAt("5"), std::chrono::system_clock::time_point{});
+    ASSERT_NE(reloaded.get("5"), nullptr);
+    EXPECT_EQ(reloaded.getCheckedAt("5"), fetched);
+}
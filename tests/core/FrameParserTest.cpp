@@ -0,0 +1,53 @@
+#include "core/FrameParser.hpp"
+#include <gtest/gtest.h>
+
+using namespace podradio::core;
+
+TEST(FrameParserTest, SplitsLinesAcrossChunks) {
+    FrameParser parser;
+    std::string_view frame;
+
+    parser.append("{\"a\":1}\n{\"b\"");
+    ASSERT_TRUE(parser.next(frame));
+    EXPECT_EQ(frame, "{\"a\":1}");
+    EXPECT_FALSE(parser.next(frame));
+
+    parser.append(":2}\r\n\n");
+    ASSERT_TRUE(parser.next(frame));
+    EXPECT_EQ(frame, "{\"b\":2}");
+    EXPECT_FALSE(parser.next(frame));
+    EXPECT_EQ(parser.buffered(), 0u);
+}
+
+TEST(FrameParserTest, SwitchesToLengthPrefixedFrames) {
+    FrameParser parser;
+    std::string input = "{\"action\":\"set_encoding\"}\n";
+    std::string payload("\x01\x00\x02", 3);
+    FrameParser::appendLengthPrefix(input, static_cast<uint32_t>(payload.size()));
+    input += payload;
+
+    parser.append(input.substr(0, input.size() - 1));
+    std::string_view frame;
+    ASSERT_TRUE(parser.next(frame));
+    parser.setFraming(FrameParser::Framing::LengthPrefixed);
+    EXPECT_FALSE(parser.next(frame));
+
+    parser.append(input.substr(input.size() - 1));
+    ASSERT_TRUE(parser.next(frame));
+    EXPECT_EQ(frame, payload);
+}
+
+TEST(FrameParserTest, RejectsOversizedFrames) {
+    FrameParser lines(8);
+    lines.append("0123456789");
+    std::string_view frame;
+    EXPECT_FALSE(lines.next(frame));
+    EXPECT_TRUE(lines.hasError());
+
+    FrameParser prefixed(8, FrameParser::Framing::LengthPrefixed);
+    std::string header;
+    FrameParser::appendLengthPrefix(header, 1000);
+    prefixed.append(header);
+    EXPECT_FALSE(prefixed.next(frame));
+    EXPECT_TRUE(prefixed.hasError());
+}
@@ -0,0 +1,60 @@
+#include "core/HttpClient.hpp"
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+using namespace podradio::core;
+
+TEST(HttpClientTest, ReusesSessionsPerOrigin) {
+    HttpClient& client = HttpClient::shared();
+    size_t idle = client.getIdleSessionCount();
+
+    cpr::Session* first = nullptr;
+    {
+        auto a = client.acquire("https://feeds.example.com/a.rss");
+        auto b = client.acquire("https://feeds.example.com/b.rss");
+        first = &*a;
+        EXPECT_NE(first, &*b);
+    }
+    EXPECT_EQ(client.getIdleSessionCount(), idle + 2);
+
+    // Same origin gets a pooled session back; another origin doesn't
+    auto other = client.acquire("https://cdn.example.net/episode.mp3");
+    EXPECT_EQ(client.getIdleSessionCount(), idle + 2);
+    auto again = client.acquire("https://feeds.example.com/c.rss");
+    EXPECT_EQ(client.getIdleSessionCount(), idle + 1);
+}
+
+TEST(HttpClientTest, GetAfterDownloadUsesFreshWriteHandling) {
+    // file:// needs no server and goes through the same curl write path
+    std::string path = (std::filesystem::temp_directory_path() / "podradio_http_client_test.txt").string();
+    {
+        std::ofstream file(path, std::ios::binary);
+        file << "episode bytes";
+    }
+    std::string url = "file://" + path;
+    HttpClient& client = HttpClient::shared();
+
+    cpr::Session* downloaded = nullptr;
+    {
+        std::string received;
+        auto lease = client.acquire(url);
+        downloaded = &*lease;
+        lease->SetUrl(cpr::Url{url});
+        lease->Download(cpr::WriteCallback{[&received](std::string data, intptr_t) {
+            received += data;
+            return true;
+        }});
+        EXPECT_EQ(received, "episode bytes");
+    }
+
+    // The pooled session must not write into the finished download's buffer
+    auto lease = client.acquire(url);
+    ASSERT_EQ(&*lease, downloaded);
+    lease->SetUrl(cpr::Url{url});
+    auto response = lease->Get();
+    EXPECT_EQ(response.text, "episode bytes");
+
+    std::filesystem::remove(path);
+}
@@ -0,0 +1,93 @@
+#include "core/Logger.hpp"
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace podradio::core;
+
+namespace {
+
+size_t countLines(const std::string& text, const std::string& prefix) {
+    std::istringstream stream(text);
+    std::string line;
+    size_t count = 0;
+    while (std::getline(stream, line)) {
+        if (line.rfind(prefix, 0) == 0) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+} // namespace
+
+TEST(LoggerTest, ParsesLevelNames) {
+    LogLevel level = LogLevel::Info;
+    EXPECT_TRUE(Logger::parseLevel("debug", level));
+    EXPECT_EQ(level, LogLevel::Debug);
+    EXPECT_TRUE(Logger::parseLevel("warn", level));
+    EXPECT_EQ(level, LogLevel::Warning);
+    EXPECT_FALSE(Logger::parseLevel("loud", level));
+    EXPECT_EQ(level, LogLevel::Warning);
+}
+
+TEST(LoggerTest, FiltersByLevelAndSplitsStreams) {
+    testing::internal::CaptureStdout();
+    testing::internal::CaptureStderr();
+    {
+        Logger logger;
+        logger.setLevel(LogLevel::Info);
+        EXPECT_FALSE(logger.enabled(LogLevel::Debug));
+        logger.log(LogLevel::Debug, "hidden");
+        logger.log(LogLevel::Info, "first");
+        logger.log(LogLevel::Error, "broken");
+        logger.log(LogLevel::Info, "second");
+        logger.flush();
+    }
+    std::string out = testing::internal::GetCapturedStdout();
+    std::string err = testing::internal::GetCapturedStderr();
+
+    EXPECT_EQ(out, "first\nsecond\n");
+    EXPECT_EQ(err, "broken\n");
+}
+
+TEST(LoggerTest, KeepsEveryMessageOrCountsItAsDropped) {
+    testing::internal::CaptureStdout();
+    testing::internal::CaptureStderr();
+    uint64_t dropped;
+    {
+        Logger logger(4);
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t) {
+            threads.emplace_back([&logger, t] {
+                for (int i = 0; i < 500; ++i) {
+                    logger.log(LogLevel::Info, "msg " + std::to_string(t) + " " + std::to_string(i));
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        logger.flush();
+        dropped = logger.getDroppedCount();
+    }
+    std::string out = testing::internal::GetCapturedStdout();
+    std::string err = testing::internal::GetCapturedStderr();
+
+    EXPECT_EQ(countLines(out, "msg ") + dropped, 2000u);
+    if (dropped > 0) {
+        EXPECT_NE(err.find("Logger dropped"), std::string::npos);
+    }
+}
+
+TEST(LoggerTest, WritesSynchronouslyAfterShutdown) {
+    testing::internal::CaptureStdout();
+    {
+        Logger logger;
+        logger.shutdown();
+        logger.log(LogLevel::Info, "late");
+    }
+    EXPECT_EQ(testing::internal::GetCapturedStdout(), "late\n");
+}
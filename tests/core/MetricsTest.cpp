@@ -0,0 +1,58 @@
+#include "core/Metrics.hpp"
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+using namespace podradio::core;
+
+TEST(MetricsTest, BucketsBoundRelativeError) {
+    for (uint64_t value : std::vector<uint64_t>{0, 7, 8, 1000, 123456789, UINT64_MAX}) {
+        size_t bucket = Histogram::bucketOf(value);
+        uint64_t upper = Histogram::bucketUpperBound(bucket);
+        EXPECT_GE(upper, value);
+        EXPECT_LE(upper - value, value / 8) << value;
+    }
+    EXPECT_LE(Histogram::bucketOf(999), Histogram::bucketOf(1000));
+}
+
+TEST(MetricsTest, SummarizesPercentiles) {
+    Histogram histogram;
+    for (uint64_t i = 1; i <= 1000; ++i) {
+        histogram.record(i);
+    }
+
+    Histogram::Summary s = histogram.summarize();
+    EXPECT_EQ(s.count, 1000u);
+    EXPECT_EQ(s.min, 1u);
+    EXPECT_EQ(s.max, 1000u);
+    EXPECT_EQ(s.sum, 500500u);
+    EXPECT_NEAR(static_cast<double>(s.p50), 500.0, 500 / 8.0);
+    EXPECT_NEAR(static_cast<double>(s.p90), 900.0, 900 / 8.0);
+    EXPECT_LE(s.p99, 1000u);
+    EXPECT_GE(s.p99, 990u);
+}
+
+TEST(MetricsTest, CountsConcurrentUpdates) {
+    MetricsRegistry registry;
+    Counter& counter = registry.counter("test.events");
+    Histogram& histogram = registry.histogram("test.latency_us");
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&] {
+            for (int i = 0; i < 10000; ++i) {
+                counter.add();
+                histogram.record(i);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(&registry.counter("test.events"), &counter);
+    nlohmann::json j = registry.toJson();
+    EXPECT_EQ(j["counters"]["test.events"], 40000);
+    EXPECT_EQ(j["histograms"]["test.latency_us"]["count"], 40000);
+    EXPECT_EQ(j["histograms"]["test.latency_us"]["max"], 9999);
+}
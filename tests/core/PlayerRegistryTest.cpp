@@ -0,0 +1,55 @@
+#include "core/PlayerRegistry.hpp"
+#include <gtest/gtest.h>
+#include <stdexcept>
+
+using namespace podradio::core;
+
+TEST(PlayerRegistryTest, CreatesDefaultZoneOnDemand) {
+    PlayerRegistry players;
+    EXPECT_EQ(players.size(), 0u);
+    EXPECT_EQ(players.find(""), nullptr);
+
+    Player& player = players.getDefault();
+    EXPECT_EQ(players.size(), 1u);
+    EXPECT_EQ(players.getDefaultName(), PlayerRegistry::kDefaultZone);
+    EXPECT_EQ(players.find(""), &player);
+    EXPECT_EQ(&players.getDefault(), &player);
+}
+
+TEST(PlayerRegistryTest, AddsIndependentZones) {
+    PlayerRegistry players("low-latency");
+    Player& kitchen = players.add("kitchen", "hw:1,0");
+    Player& garden = players.add("garden");
+
+    EXPECT_NE(&kitchen, &garden);
+    EXPECT_EQ(players.find("kitchen"), &kitchen);
+    EXPECT_EQ(players.find("garden"), &garden);
+    EXPECT_EQ(players.find("attic"), nullptr);
+    EXPECT_EQ(&players.getDefault(), &kitchen); // First zone added
+    EXPECT_EQ(players.getZoneNames(), (std::vector<std::string>{"kitchen", "garden"}));
+
+    EXPECT_EQ(kitchen.getAudioDevice(), "hw:1,0");
+    EXPECT_EQ(garden.getAudioDevice(), "");
+    EXPECT_EQ(garden.getCachingProfile(), "low-latency");
+    EXPECT_FALSE(kitchen.isPlaying());
+}
+
+TEST(PlayerRegistryTest, RejectsDuplicateAndEmptyNames) {
+    PlayerRegistry players;
+    players.add("kitchen");
+    EXPECT_THROW(players.add("kitchen"), std::runtime_error);
+    EXPECT_THROW(players.add(""), std::runtime_error);
+    EXPECT_EQ(players.size(), 1u);
+}
+
+TEST(PlayerRegistryTest, AppliesCachingProfileToEveryZone) {
+    PlayerRegistry players;
+    players.add("kitchen");
+    players.setCachingProfile("high-loss");
+    players.add("garden");
+
+    players.forEach([](const std::string&, Player& player) {
+        EXPECT_EQ(player.getCachingProfile(), "high-loss");
+    });
+    EXPECT_THROW(players.setCachingProfile("bogus"), std::runtime_error);
+}
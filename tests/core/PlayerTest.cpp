@@ -26,4 +26,19 @@ TEST(PlayerTest, PlayPauseStop) {
     player.play(test_url);
     player.stop();
     EXPECT_FALSE(player.isPlaying());
-} 
\ No newline at end of file
+} 
+
+TEST(PlayerTest, CancelledPlayAsyncNeverStarts) {
+    Player player;
+    bool reported = false;
+    bool started = true;
+
+    player.playAsync("https://example.com/episode.mp3", [&](bool success, const std::string&) {
+        reported = true;
+        started = success;
+    }, [] { return true; });
+
+    EXPECT_TRUE(reported);
+    EXPECT_FALSE(started);
+    EXPECT_FALSE(player.isPlaying());
+}
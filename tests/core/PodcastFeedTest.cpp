@@ -0,0 +1,76 @@
+#include "core/PodcastFeed.hpp"
+#include "core/ThreadPool.hpp"
+#include <gtest/gtest.h>
+#include <string>
+
+using namespace podradio::core;
+
+namespace {
+
+// Every seventh item has no playable URL and must be skipped
+std::string makeFeed(size_t itemCount) {
+    std::string xml = "<rss version=\"2.0\"><channel><title>Big Show</title>";
+    for (size_t i = 0; i < itemCount; ++i) {
+        std::string n = std::to_string(i);
+        xml += "<item><title>Episode " + n + "</title><guid>ep-" + n + "</guid>";
+        if (i % 7 != 3) {
+            xml += "<enclosure url=\"https://cdn.example.com/" + n + ".mp3\" type=\"audio/mpeg\"/>";
+        }
+        xml += "</item>";
+    }
+    xml += "</channel></rss>";
+    return xml;
+}
+
+} // namespace
+
+TEST(PodcastFeedTest, ParallelParseKeepsFeedOrder) {
+    std::string xml = makeFeed(1000);
+
+    PodcastFeed serial;
+    serial.loadFromString(xml);
+
+    ThreadPool pool(4);
+    FeedLoadOptions options;
+    options.parsePool = &pool;
+    PodcastFeed parallel;
+    parallel.loadFromString(xml, options);
+
+    const EpisodeStore& expected = serial.getEpisodes();
+    const EpisodeStore& actual = parallel.getEpisodes();
+    ASSERT_EQ(expected.size(), 1000u - 143u);
+    ASSERT_EQ(actual.size(), expected.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+        EXPECT_EQ(actual[i].guid, expected[i].guid);
+        EXPECT_EQ(actual[i].url, expected[i].url);
+    }
+    EXPECT_EQ(parallel.getTitle(), "Big Show");
+}
+
+TEST(PodcastFeedTest, ParallelParseStopsAtKnownGuid) {
+    ThreadPool pool(2);
+    FeedLoadOptions options;
+    options.parsePool = &pool;
+    options.isKnownGuid = [](std::string_view guid) { return guid == "ep-500"; };
+
+    PodcastFeed feed;
+    feed.loadFromString(makeFeed(1000), options);
+
+    EXPECT_TRUE(feed.reachedKnownGuid());
+    ASSERT_EQ(feed.getEpisodes().size(), 500u - 71u);
+    EXPECT_EQ(feed.getEpisodes()[0].guid, "ep-0");
+}
+
+TEST(PodcastFeedTest, LinkIsPreferredOverGuidWithoutEnclosure) {
+    PodcastFeed feed;
+    feed.loadFromString(
+        "<rss version=\"2.0\"><channel><title>Show</title>"
+        "<item><title>Both</title><link>https://example.com/episodes/1</link>"
+        "<guid>https://cdn.example.com/1.mp3</guid></item>"
+        "<item><title>Guid only</title><guid>https://cdn.example.com/2.mp3</guid></item>"
+        "</channel></rss>");
+
+    ASSERT_EQ(feed.getEpisodes().size(), 2u);
+    EXPECT_EQ(feed.getEpisodes()[0].url, "https://example.com/episodes/1");
+    EXPECT_EQ(feed.getEpisodes()[1].url, "https://cdn.example.com/2.mp3");
+}
@@ -0,0 +1,51 @@
+#include "core/PositionStore.hpp"
+#include <gtest/gtest.h>
+#include <filesystem>
+
+using namespace podradio::core;
+
+namespace {
+
+class PositionStoreTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        path_ = (std::filesystem::temp_directory_path() / "podradio_positions_test.json").string();
+        std::filesystem::remove(path_);
+    }
+
+    void TearDown() override {
+        std::filesystem::remove(path_);
+    }
+
+    std::string path_;
+};
+
+} // namespace
+
+TEST_F(PositionStoreTest, ResumesSlightlyBeforeSavedPosition) {
+    PositionStore store(path_);
+    EXPECT_EQ(store.getResumePosition("ep-1"), 0);
+
+    store.update("ep-1", 5000, 3600000);
+    EXPECT_EQ(store.getResumePosition("ep-1"), 0); // Barely started
+
+    store.update("ep-1", 600000, 3600000);
+    EXPECT_EQ(store.getResumePosition("ep-1"), 597000);
+
+    store.update("ep-1", 3590000, 3600000);
+    EXPECT_EQ(store.getResumePosition("ep-1"), 0); // Practically finished
+}
+
+TEST_F(PositionStoreTest, PersistsAndForgetsFinished) {
+    {
+        PositionStore store(path_);
+        store.update("ep-1", 120000, 0);
+        store.update("ep-2", 240000, 0);
+        store.markFinished("ep-2");
+    } // Destruction writes the pending batch
+
+    PositionStore reloaded(path_);
+    EXPECT_EQ(reloaded.size(), 1u);
+    EXPECT_EQ(reloaded.getResumePosition("ep-1"), 117000);
+    EXPECT_EQ(reloaded.getResumePosition("ep-2"), 0);
+}
@@ -0,0 +1,165 @@
+#include "core/RefreshSchedule.hpp"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace podradio::core;
+using namespace std::chrono_literals;
+
+namespace {
+
+using Clock = RefreshSchedule::Clock;
+
+Clock::time_point at(const std::string& pubDate) {
+    auto time = RefreshSchedule::parsePubDate(pubDate);
+    EXPECT_TRUE(time.has_value()) << pubDate;
+    return time.value_or(Clock::time_point{});
+}
+
+Subscription makeSubscription(const std::string& name, Clock::time_point lastUpdated) {
+    Subscription subscription(name, "https://" + name + ".example.com/feed.xml");
+    subscription.lastUpdated = lastUpdated;
+    return subscription;
+}
+
+SubscriptionSnapshot makeSnapshot(const std::vector<Subscription>& subscriptions) {
+    std::vector<SubscriptionSnapshot::Item> items;
+    for (const auto& subscription : subscriptions) {
+        items.push_back(std::make_shared<const Subscription>(subscription));
+    }
+    return SubscriptionSnapshot(std::move(items));
+}
+
+// Newest first, like a feed
+FeedCacheEntry makeEntry(const std::vector<std::pair<std::string, std::string>>& guidsAndDates) {
+    FeedCacheEntry entry;
+    for (const auto& [guid, pubDate] : guidsAndDates) {
+        entry.episodes.add("Episode " + guid, "", "https://example.com/" + guid + ".mp3", pubDate, "", guid);
+    }
+    return entry;
+}
+
+FeedCacheEntry makeDailyEntry() {
+    return makeEntry({
+        {"d5", "Mon, 05 Aug 2024 06:00:00 GMT"},
+        {"d4", "Sun, 04 Aug 2024 06:00:00 GMT"},
+        {"d3", "Sat, 03 Aug 2024 06:00:00 GMT"},
+        {"d2", "Fri, 02 Aug 2024 06:00:00 GMT"},
+    });
+}
+
+RefreshOptions deterministicOptions() {
+    RefreshOptions options;
+    options.jitter = 0;
+    return options;
+}
+
+} // namespace
+
+TEST(RefreshScheduleTest, ParsesPubDates) {
+    const Clock::time_point expected{std::chrono::seconds(1722848400)}; // 2024-08-05 09:00 UTC
+
+    EXPECT_EQ(at("Mon, 05 Aug 2024 09:00:00 GMT"), expected);
+    EXPECT_EQ(at("Monday, 5 August 2024 11:00:00 +0200"), expected);
+    EXPECT_EQ(at("05 Aug 24 05:00 EDT"), expected);
+    EXPECT_EQ(at("2024-08-05T09:00:00Z"), expected);
+    EXPECT_EQ(at("2024-08-05T04:00:00.250-05:00"), expected);
+    EXPECT_EQ(at("Mon, 05 Aug 2024"), expected - 9h);
+
+    EXPECT_FALSE(RefreshSchedule::parsePubDate("").has_value());
+    EXPECT_FALSE(RefreshSchedule::parsePubDate("yesterday").has_value());
+    EXPECT_FALSE(RefreshSchedule::parsePubDate("Mon, 05 Foo 2024 09:00:00 GMT").has_value());
+    EXPECT_FALSE(RefreshSchedule::parsePubDate("Mon, 05 Aug 2024 25:00:00 GMT").has_value());
+}
+
+TEST(RefreshScheduleTest, EstimatesPublishIntervalFromRecentEpisodes) {
+    // Weekly show with one bonus episode; the median ignores it
+    auto weekly = makeEntry({
+        {"w5", "Mon, 29 Jul 2024 06:00:00 GMT"},
+        {"bonus", "Fri, 26 Jul 2024 06:00:00 GMT"},
+        {"w4", "Mon, 22 Jul 2024 06:00:00 GMT"},
+        {"w3", "Mon, 15 Jul 2024 06:00:00 GMT"},
+        {"w2", "Mon, 08 Jul 2024 06:00:00 GMT"},
+        {"w1", "Mon, 01 Jul 2024 06:00:00 GMT"},
+    });
+    EXPECT_EQ(RefreshSchedule::estimatePublishInterval(weekly.episodes), std::chrono::seconds(7 * 24h));
+
+    // Too few dated episodes to tell
+    auto sparse = makeEntry({
+        {"a", "Mon, 29 Jul 2024 06:00:00 GMT"},
+        {"b", ""},
+        {"c", "Mon, 22 Jul 2024 06:00:00 GMT"},
+    });
+    EXPECT_FALSE(RefreshSchedule::estimatePublishInterval(sparse.episodes).has_value());
+}
+
+TEST(RefreshScheduleTest, HandsOutDueFeedsByFreshnessGain) {
+    auto now = at("Mon, 05 Aug 2024 12:00:00 GMT");
+    RefreshSchedule schedule(deterministicOptions());
+
+    auto recent = makeSubscription("recent", now - 20min);
+    auto stale = makeSubscription("stale", now - 3h);
+    auto fresh = makeSubscription("fresh", now - 5min);
+    auto disabled = makeSubscription("disabled", Clock::time_point{});
+    disabled.enabled = false;
+    schedule.sync(makeSnapshot({recent, stale, fresh, disabled}), now);
+    EXPECT_EQ(schedule.size(), 3u);
+
+    auto due = schedule.takeDue(now);
+    ASSERT_EQ(due.size(), 2u);
+    EXPECT_EQ(due[0]->name, "stale");
+    EXPECT_EQ(due[1]->name, "recent");
+
+    // In-flight feeds are not handed out twice
+    EXPECT_TRUE(schedule.takeDue(now).empty());
+    EXPECT_EQ(schedule.nextDue(), fresh.lastUpdated + 15min);
+
+    // Subscriptions added later are due at once
+    auto added = makeSubscription("added", now);
+    schedule.sync(makeSnapshot({recent, stale, fresh, added}), now);
+    due = schedule.takeDue(now);
+    ASSERT_EQ(due.size(), 1u);
+    EXPECT_EQ(due[0]->name, "added");
+}
+
+TEST(RefreshScheduleTest, FollowsPublishCadenceAndBacksOffFailures) {
+    auto now = at("Mon, 05 Aug 2024 12:00:00 GMT");
+    RefreshSchedule schedule(deterministicOptions());
+
+    auto daily = makeSubscription("daily", Clock::time_point{});
+    auto broken = makeSubscription("broken", Clock::time_point{});
+    schedule.sync(makeSnapshot({daily, broken}), now);
+    ASSERT_EQ(schedule.takeDue(now).size(), 2u);
+
+    // A daily feed is checked every six hours to begin with...
+    auto entry = makeDailyEntry();
+    schedule.recordSuccess(daily.id, entry, now);
+    EXPECT_EQ(schedule.getPublishInterval(daily.id), std::chrono::seconds(24h));
+    EXPECT_EQ(schedule.getNextCheck(daily.id), now + 6h);
+
+    // ...and less often while checks keep finding nothing new
+    auto checked = now;
+    for (int i = 0; i < 5; ++i) {
+        checked += 6h;
+        schedule.recordSuccess(daily.id, entry, checked);
+    }
+    auto stretched = *schedule.getNextCheck(daily.id) - checked;
+    EXPECT_GT(stretched, 6h);
+    EXPECT_LE(stretched, 24h);
+
+    // Failing feeds back off exponentially from minInterval
+    schedule.recordFailure(broken.id, now);
+    EXPECT_EQ(schedule.getNextCheck(broken.id), now + 15min);
+    schedule.recordFailure(broken.id, now);
+    EXPECT_EQ(schedule.getNextCheck(broken.id), now + 30min);
+    for (int i = 0; i < 10; ++i) {
+        schedule.recordFailure(broken.id, now);
+    }
+    EXPECT_EQ(schedule.getNextCheck(broken.id), now + 24h);
+
+    // A success resets the backoff
+    schedule.recordSuccess(broken.id, FeedCacheEntry{}, now);
+    EXPECT_EQ(schedule.getNextCheck(broken.id), now + 30min);
+}
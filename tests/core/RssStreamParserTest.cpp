@@ -0,0 +1,123 @@
+#include "core/RssStreamParser.hpp"
+#include <gtest/gtest.h>
+#include <vector>
+
+using namespace podradio::core;
+
+namespace {
+
+const char* kFeed = R"(<?xml version="1.0" encoding="UTF-8"?>
+<!-- sample feed -->
+<rss version="2.0" xmlns:itunes="http://www.itunes.com/dtds/podcast-1.0.dtd">
+  <channel>
+    <title>Test &amp; Friends</title>
+    <description><![CDATA[A <b>show</b> about tests]]></description>
+    <link>https://example.com</link>
+    <language>en</language>
+    <item>
+      <title>Episode 2</title>
+      <description>Second &lt;episode&gt; &#8211; newest</description>
+      <pubDate>Tue, 02 Jan 2024 10:00:00 GMT</pubDate>
+      <itunes:duration>01:02:03</itunes:duration>
+      <guid isPermaLink="false">ep-2</guid>
+      <enclosure url="https://cdn.example.com/ep2.mp3?a=1&amp;b=2" type="audio/mpeg" length="1"/>
+    </item>
+    <item>
+      <title>Episode 1</title>
+      <guid>ep-1</guid>
+      <media:content url='https://cdn.example.com/ep1.m4a' type='audio/mp4'/>
+    </item>
+  </channel>
+</rss>
+)";
+
+std::vector<RssItem> parseInChunks(const std::string& xml, size_t chunkSize, RssChannel* channel = nullptr) {
+    std::vector<RssItem> items;
+    RssStreamParser parser([&items](RssItem& item) {
+        items.push_back(item);
+        return true;
+    });
+    for (size_t pos = 0; pos < xml.size(); pos += chunkSize) {
+        parser.feed(std::string_view(xml).substr(pos, chunkSize));
+    }
+    EXPECT_TRUE(parser.finish()) << parser.getError();
+    EXPECT_TRUE(parser.foundChannel());
+    if (channel) {
+        *channel = parser.getChannel();
+    }
+    return items;
+}
+
+} // namespace
+
+TEST(RssStreamParserTest, ParsesChannelAndItems) {
+    RssChannel channel;
+    auto items = parseInChunks(kFeed, std::string(kFeed).size(), &channel);
+
+    EXPECT_EQ(channel.title, "Test & Friends");
+    EXPECT_EQ(channel.description, "A <b>show</b> about tests");
+    EXPECT_EQ(channel.language, "en");
+
+    ASSERT_EQ(items.size(), 2u);
+    EXPECT_EQ(items[0].title, "Episode 2");
+    EXPECT_TRUE(items[0].descriptionEncoded);
+    EXPECT_EQ(RssStreamParser::decodeEntities(items[0].description), "Second <episode> \xE2\x80\x93 newest");
+    EXPECT_EQ(items[0].duration, "01:02:03");
+    EXPECT_EQ(items[0].guid, "ep-2");
+    EXPECT_EQ(items[0].enclosureUrl, "https://cdn.example.com/ep2.mp3?a=1&b=2");
+    EXPECT_EQ(items[0].enclosureType, "audio/mpeg");
+    EXPECT_EQ(items[1].mediaUrl, "https://cdn.example.com/ep1.m4a");
+    EXPECT_EQ(items[1].mediaType, "audio/mp4");
+}
+
+TEST(RssStreamParserTest, ChunkBoundariesDoNotMatter) {
+    auto whole = parseInChunks(kFeed, std::string(kFeed).size());
+    for (size_t chunkSize : {1u, 2u, 3u, 7u, 64u}) {
+        auto chunked = parseInChunks(kFeed, chunkSize);
+        ASSERT_EQ(chunked.size(), whole.size()) << "chunk size " << chunkSize;
+        for (size_t i = 0; i < whole.size(); ++i) {
+            EXPECT_EQ(chunked[i].title, whole[i].title);
+            EXPECT_EQ(chunked[i].description, whole[i].description);
+            EXPECT_EQ(chunked[i].enclosureUrl, whole[i].enclosureUrl);
+            EXPECT_EQ(chunked[i].mediaUrl, whole[i].mediaUrl);
+        }
+    }
+}
+
+TEST(RssStreamParserTest, MixedDescriptionFallsBackToDecoded) {
+    std::vector<RssItem> items;
+    RssStreamParser parser([&items](RssItem& item) {
+        items.push_back(item);
+        return true;
+    });
+    parser.feed("<rss><channel><item><description>a &amp; b <![CDATA[c & d]]> &lt;e&gt;"
+                "</description></item></channel></rss>");
+    ASSERT_TRUE(parser.finish());
+    ASSERT_EQ(items.size(), 1u);
+    EXPECT_FALSE(items[0].descriptionEncoded);
+    EXPECT_EQ(items[0].description, "a & b c & d <e>");
+}
+
+TEST(RssStreamParserTest, HandlerCanStopEarly) {
+    int seen = 0;
+    RssStreamParser parser([&seen](RssItem&) {
+        seen++;
+        return false;
+    });
+    EXPECT_FALSE(parser.feed(kFeed));
+    EXPECT_TRUE(parser.stopped());
+    EXPECT_FALSE(parser.hasError());
+    EXPECT_TRUE(parser.finish());
+    EXPECT_EQ(seen, 1);
+}
+
+TEST(RssStreamParserTest, ReportsMalformedDocuments) {
+    RssStreamParser mismatched([](RssItem&) { return true; });
+    mismatched.feed("<rss><channel><title>x</channel></rss>");
+    EXPECT_FALSE(mismatched.finish());
+    EXPECT_TRUE(mismatched.hasError());
+
+    RssStreamParser truncated([](RssItem&) { return true; });
+    truncated.feed("<rss><channel><item><title>x</title>");
+    EXPECT_FALSE(truncated.finish());
+}
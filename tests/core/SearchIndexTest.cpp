@@ -0,0 +1,127 @@
+#include "core/SearchIndex.hpp"
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace podradio::core;
+
+namespace {
+
+SubscriptionSnapshot::Ptr makeSnapshot(const std::vector<Subscription>& subscriptions) {
+    std::vector<SubscriptionSnapshot::Item> items;
+    for (const auto& subscription : subscriptions) {
+        items.push_back(std::make_shared<const Subscription>(subscription));
+    }
+    return std::make_shared<const SubscriptionSnapshot>(std::move(items));
+}
+
+std::shared_ptr<const FeedCacheEntry> makeEntry(const std::vector<Episode>& episodes) {
+    FeedCacheEntry entry;
+    for (const auto& episode : episodes) {
+        entry.episodes.add(episode);
+    }
+    return std::make_shared<const FeedCacheEntry>(std::move(entry));
+}
+
+Episode makeEpisode(const std::string& guid, const std::string& title, const std::string& description = "") {
+    Episode episode;
+    episode.guid = guid;
+    episode.title = title;
+    episode.description = description;
+    episode.url = "https://example.com/" + guid + ".mp3";
+    return episode;
+}
+
+std::vector<std::string> titlesOf(const SearchResults& results) {
+    std::vector<std::string> titles;
+    for (const auto& hit : results.hits) {
+        if (hit.isEpisode()) {
+            titles.emplace_back(hit.entry->episodes[hit.episodeIndex].title);
+        } else {
+            titles.push_back("podcast:" + hit.subscriptionId);
+        }
+    }
+    return titles;
+}
+
+SearchQuery query(const std::string& text, SearchScope scope = SearchScope::All) {
+    SearchQuery q;
+    q.text = text;
+    q.scope = scope;
+    return q;
+}
+
+} // namespace
+
+TEST(SearchIndexTest, TokenizesWordsAndSkipsMarkup) {
+    EXPECT_EQ(SearchIndex::tokenize("Hello, World! 42 a"), (std::vector<std::string>{"hello", "world", "42"}));
+    EXPECT_EQ(SearchIndex::tokenize("<p>Guest <b>Ada</b></p>", true), (std::vector<std::string>{"guest", "ada"}));
+}
+
+TEST(SearchIndexTest, MatchesAllWordsWithPrefixOnTheLast) {
+    Subscription science("Science Weekly", "https://example.com/science.xml");
+    SearchIndex index;
+    index.syncSubscriptions(*makeSnapshot({science}));
+    index.setEpisodes(science.id, makeEntry({
+        makeEpisode("1", "Black holes explained", "An interview about gravity"),
+        makeEpisode("2", "Gravity waves"),
+        makeEpisode("3", "Cooking with science", "<p>Kitchen <i>chemistry</i></p>")
+    }));
+
+    EXPECT_EQ(titlesOf(index.search(query("gravity"))),
+              (std::vector<std::string>{"Gravity waves", "Black holes explained"})); // Title match ranks first
+    EXPECT_EQ(titlesOf(index.search(query("black grav"))), (std::vector<std::string>{"Black holes explained"}));
+    EXPECT_EQ(titlesOf(index.search(query("chemistry"))), (std::vector<std::string>{"Cooking with science"}));
+    EXPECT_TRUE(index.search(query("grav black")).hits.empty()); // Only the last word is a prefix
+
+    SearchResults podcasts = index.search(query("science", SearchScope::Podcasts));
+    ASSERT_EQ(podcasts.hits.size(), 1u);
+    EXPECT_FALSE(podcasts.hits[0].isEpisode());
+    EXPECT_EQ(podcasts.hits[0].subscriptionId, science.id);
+}
+
+TEST(SearchIndexTest, Paginates) {
+    Subscription show("Show", "https://example.com/show.xml");
+    std::vector<Episode> episodes;
+    for (int i = 0; i < 25; ++i) {
+        episodes.push_back(makeEpisode(std::to_string(i), "Episode " + std::to_string(i)));
+    }
+    SearchIndex index;
+    index.syncSubscriptions(*makeSnapshot({show}));
+    index.setEpisodes(show.id, makeEntry(episodes));
+
+    SearchQuery page = query("episode", SearchScope::Episodes);
+    page.limit = 10;
+    page.offset = 20;
+    SearchResults results = index.search(page);
+    EXPECT_EQ(results.total, 25u);
+    EXPECT_EQ(titlesOf(results), (std::vector<std::string>{
+        "Episode 20", "Episode 21", "Episode 22", "Episode 23", "Episode 24"})); // Feed order on ties
+}
+
+TEST(SearchIndexTest, UpdatesIncrementally) {
+    Subscription show("Show", "https://example.com/show.xml");
+    Subscription other("Other", "https://example.com/other.xml");
+    SearchIndex index;
+    index.syncSubscriptions(*makeSnapshot({show, other}));
+    EXPECT_EQ(index.getUnindexedSubscriptions().size(), 2u);
+
+    index.setEpisodes(show.id, makeEntry({makeEpisode("1", "Old news"), makeEpisode("2", "Kept story")}));
+    index.setEpisodes(show.id, makeEntry({makeEpisode("3", "Fresh news"), makeEpisode("2", "Kept story")}));
+    EXPECT_EQ(titlesOf(index.search(query("news"))), (std::vector<std::string>{"Fresh news"}));
+    SearchResults kept = index.search(query("kept"));
+    ASSERT_EQ(kept.hits.size(), 1u);
+    EXPECT_EQ(kept.hits[0].episodeIndex, 1u); // Moved down by the new episode
+
+    // An older entry must not replace the one a refresh set
+    index.fillEpisodes(show.id, makeEntry({makeEpisode("1", "Old news")}));
+    EXPECT_TRUE(index.search(query("old")).hits.empty());
+    EXPECT_EQ(index.getUnindexedSubscriptions(), (std::vector<std::string>{other.id}));
+
+    // Dropping a subscription drops its episodes and their terms
+    index.syncSubscriptions(*makeSnapshot({other}));
+    EXPECT_TRUE(index.search(query("story")).hits.empty());
+    EXPECT_EQ(index.getDocumentCount(), 1u);
+    EXPECT_EQ(index.getTermCount(), 1u); // "other"
+}
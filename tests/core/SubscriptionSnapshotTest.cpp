@@ -0,0 +1,51 @@
+#include "core/SubscriptionSnapshot.hpp"
+#include <gtest/gtest.h>
+
+using namespace podradio::core;
+
+namespace {
+
+std::vector<SubscriptionSnapshot::Item> makeItems() {
+    return {
+        std::make_shared<const Subscription>("Alpha", "https://example.com/alpha.rss"),
+        std::make_shared<const Subscription>("Beta", "https://example.com/beta.rss"),
+        std::make_shared<const Subscription>("Gamma", "https://example.com/gamma.rss")
+    };
+}
+
+} // namespace
+
+TEST(SubscriptionSnapshotTest, FindsByNameUrlAndId) {
+    SubscriptionSnapshot snapshot(makeItems());
+    ASSERT_EQ(snapshot.size(), 3u);
+
+    EXPECT_EQ(snapshot.find("Beta"), 1);
+    EXPECT_EQ(snapshot.find("https://example.com/gamma.rss"), 2);
+    EXPECT_EQ(snapshot.find(snapshot[0].id), 0);
+    EXPECT_EQ(snapshot.find("Delta"), -1);
+}
+
+TEST(SubscriptionSnapshotTest, EarliestMatchWins) {
+    auto items = makeItems();
+    // A later subscription whose name equals an earlier one's feed URL
+    items.push_back(std::make_shared<const Subscription>("https://example.com/alpha.rss", "https://example.com/other.rss"));
+    SubscriptionSnapshot snapshot(std::move(items));
+
+    EXPECT_EQ(snapshot.find("https://example.com/alpha.rss"), 0);
+}
+
+TEST(SubscriptionSnapshotTest, OlderSnapshotSurvivesReplacement) {
+    auto first = std::make_shared<const SubscriptionSnapshot>(makeItems());
+    SubscriptionSnapshot::Item held = first->at(1);
+
+    auto items = first->items();
+    auto updated = std::make_shared<Subscription>(*items[1]);
+    updated->description = "changed";
+    items[1] = updated;
+    auto second = std::make_shared<const SubscriptionSnapshot>(std::move(items), first->index());
+    first.reset();
+
+    EXPECT_EQ(held->description, "");
+    EXPECT_EQ((*second)[1].description, "changed");
+    EXPECT_EQ(second->find("Beta"), 1);
+}
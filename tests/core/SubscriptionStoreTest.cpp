@@ -0,0 +1,44 @@
+#include "core/SubscriptionStore.hpp"
+#include "core/DebouncedWriter.hpp"
+#include <gtest/gtest.h>
+#include <filesystem>
+
+using namespace podradio::core;
+
+TEST(SubscriptionStoreTest, RoundTripsThroughMappedFile) {
+    auto disabled = std::make_shared<Subscription>("Beta", "https://example.com/beta.rss", "Second show");
+    disabled->enabled = false;
+    SubscriptionSnapshot snapshot({
+        std::make_shared<const Subscription>("Alpha", "https://example.com/alpha.rss"),
+        disabled
+    });
+
+    std::string path = (std::filesystem::temp_directory_path() / "podradio_store_test.bin").string();
+    ASSERT_TRUE(writeFileAtomically(path, SubscriptionStore::encode(snapshot, 1)));
+
+    std::vector<SubscriptionSnapshot::Item> items;
+    int index = -1;
+    ASSERT_TRUE(SubscriptionStore::load(path, items, index));
+    std::filesystem::remove(path);
+
+    ASSERT_EQ(items.size(), 2u);
+    EXPECT_EQ(index, 1);
+    EXPECT_EQ(items[0]->name, "Alpha");
+    EXPECT_EQ(items[0]->id, snapshot[0].id);
+    EXPECT_TRUE(items[0]->enabled);
+    EXPECT_EQ(items[1]->feedUrl, "https://example.com/beta.rss");
+    EXPECT_EQ(items[1]->description, "Second show");
+    EXPECT_FALSE(items[1]->enabled);
+}
+
+TEST(SubscriptionStoreTest, RejectsTruncatedData) {
+    SubscriptionSnapshot snapshot({std::make_shared<const Subscription>("Alpha", "https://example.com/alpha.rss")});
+    std::string encoded = SubscriptionStore::encode(snapshot, 0);
+
+    std::vector<SubscriptionSnapshot::Item> items;
+    int index = 0;
+    EXPECT_TRUE(SubscriptionStore::decode(encoded.data(), encoded.size(), items, index));
+    EXPECT_FALSE(SubscriptionStore::decode(encoded.data(), encoded.size() - 1, items, index));
+    EXPECT_FALSE(SubscriptionStore::decode("{\"subscriptions\":[]}", 20, items, index));
+    EXPECT_EQ(items.size(), 1u); // Failed decodes leave the output alone
+}
@@ -0,0 +1,34 @@
+#include "core/UrlClassifier.hpp"
+#include <gtest/gtest.h>
+
+using namespace podradio::core;
+
+TEST(UrlClassifierTest, RecognizesNormalizedUrls) {
+    EXPECT_TRUE(UrlClassifier::isNormalizedHttpUrl("https://cdn.example.com/ep%2001.mp3?id=7&t=1#x"));
+    EXPECT_TRUE(UrlClassifier::isNormalizedHttpUrl("http://example.com/"));
+
+    EXPECT_FALSE(UrlClassifier::isNormalizedHttpUrl("https://Example.com/ep.mp3"));  // Host case
+    EXPECT_FALSE(UrlClassifier::isNormalizedHttpUrl("https://example.com"));         // Missing path
+    EXPECT_FALSE(UrlClassifier::isNormalizedHttpUrl("https://example.com:443/"));    // Port
+    EXPECT_FALSE(UrlClassifier::isNormalizedHttpUrl("https://example.com/a/../b"));  // Dot segment
+    EXPECT_FALSE(UrlClassifier::isNormalizedHttpUrl("https://example.com/a b"));     // Needs encoding
+    EXPECT_FALSE(UrlClassifier::isNormalizedHttpUrl("https://1.2.3/"));              // Numeric host
+    EXPECT_FALSE(UrlClassifier::isNormalizedHttpUrl("ftp://example.com/ep.mp3"));
+}
+
+TEST(UrlClassifierTest, TrimsOnFastPath) {
+    EXPECT_EQ(UrlClassifier::clean("  https://example.com/ep.mp3\r\n"), "https://example.com/ep.mp3");
+    EXPECT_EQ(UrlClassifier::clean(" \t "), "");
+}
+
+TEST(UrlClassifierTest, ClassifiesAudioUrls) {
+    EXPECT_TRUE(UrlClassifier::looksLikeAudio("https://example.com/episodes/42.mp3"));
+    EXPECT_TRUE(UrlClassifier::looksLikeAudio("https://example.com/play?file=42.m4a"));
+    EXPECT_TRUE(UrlClassifier::looksLikeAudio("https://dts.podtrac.com/redirect/example.com/42"));
+    EXPECT_TRUE(UrlClassifier::looksLikeAudio("https://chtbl.com/track/traffic.megaphone.fm/ABC"));
+
+    EXPECT_FALSE(UrlClassifier::looksLikeAudio("https://example.com/episodes/42.html"));
+    EXPECT_FALSE(UrlClassifier::looksLikeAudio("https://mp3.example.com/episodes/42"));
+    EXPECT_FALSE(UrlClassifier::looksLikeAudio("https://example.com/page#clip.mp3"));
+    EXPECT_FALSE(UrlClassifier::looksLikeAudio(""));
+}